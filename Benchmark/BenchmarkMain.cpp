@@ -0,0 +1,175 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file BenchmarkMain.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Entry point used instead of main.cpp when the project is built
+ * with EC_BENCHMARK defined.
+ */
+
+#ifdef EC_BENCHMARK
+
+#define BENCHMARK_ITERATIONS 5
+#define SCAN_ITERATIONS 100
+#define FUZZY_ITERATIONS 100
+
+#define DATASET_1K_PATH "Benchmark1000/"
+#define DATASET_100K_PATH "Benchmark100000/"
+#define DATASET_1M_PATH "Benchmark1000000/"
+
+#define DATASET_SEED 2012
+#define COUNTRY_TABLE_FILE_NAME "CountryTable"
+
+#include <MAUtil/Moblet.h>
+#include <conprint.h>
+#include <mastdlib.h>
+#include <Wormhole/FileUtil.h>
+
+#include "DatasetGenerator.h"
+#include "FuzzyBenchmark.h"
+#include "LoadBenchmark.h"
+#include "ScanBenchmark.h"
+
+namespace EuropeanCountries
+{
+	/**
+	 * Number of heap allocations done with operator new.
+	 */
+	int gAllocationCount = 0;
+
+	/**
+	 * Moblet that runs the benchmarks and prints the results to the console.
+	 */
+	class BenchmarkMoblet : public MAUtil::Moblet
+	{
+	public:
+		/**
+		 * Constructor.
+		 */
+		BenchmarkMoblet()
+		{
+			Wormhole::FileUtil fileUtil;
+			MAUtil::String localPath = fileUtil.getLocalPath();
+
+			// Synthetic datasets are generated only once, on first run.
+			this->generateDataset(localPath + DATASET_1K_PATH, 1000);
+			this->generateDataset(localPath + DATASET_100K_PATH, 100000);
+			this->generateDataset(localPath + DATASET_1M_PATH, 1000000);
+
+			LoadBenchmark loadBenchmark(BENCHMARK_ITERATIONS);
+			loadBenchmark.addDataset("1k", localPath + DATASET_1K_PATH);
+			loadBenchmark.addDataset("100k", localPath + DATASET_100K_PATH);
+			loadBenchmark.addDataset("1M", localPath + DATASET_1M_PATH);
+			loadBenchmark.run();
+			loadBenchmark.runJobSizes("100k", localPath + DATASET_100K_PATH);
+
+			// The 1M dataset is not scanned: building the naive field list
+			// reads every country file again.
+			ScanBenchmark scanBenchmark(SCAN_ITERATIONS);
+			scanBenchmark.addDataset("1k", localPath + DATASET_1K_PATH);
+			scanBenchmark.addDataset("100k", localPath + DATASET_100K_PATH);
+			scanBenchmark.run();
+
+			FuzzyBenchmark fuzzyBenchmark(FUZZY_ITERATIONS);
+			fuzzyBenchmark.addDataset("1k", localPath + DATASET_1K_PATH);
+			fuzzyBenchmark.addDataset("100k", localPath + DATASET_100K_PATH);
+			fuzzyBenchmark.run();
+			printf("Benchmark finished. Press back to exit.\n");
+		}
+
+		/**
+		 * Called when a key is pressed.
+		 */
+		void keyPressEvent(int keyCode, int nativeCode)
+		{
+			if (MAK_BACK == keyCode || MAK_0 == keyCode)
+			{
+				MAUtil::Moblet::close();
+			}
+		}
+
+	private:
+		/**
+		 * Generate a synthetic dataset if it does not exist.
+		 * @param directoryPath Dataset directory.
+		 * @param countCountries Number of countries in dataset.
+		 */
+		void generateDataset(
+			const MAUtil::String& directoryPath,
+			const int countCountries)
+		{
+			MAUtil::String countryTablePath = directoryPath + COUNTRY_TABLE_FILE_NAME;
+			MAHandle file = maFileOpen(countryTablePath.c_str(), MA_ACCESS_READ);
+			bool exists = file >= 0 && maFileExists(file);
+			if (file >= 0)
+			{
+				maFileClose(file);
+			}
+			if (exists)
+			{
+				return;
+			}
+
+			printf("Generating %d countries into %s\n",
+				countCountries, directoryPath.c_str());
+			DatasetGenerator generator(DATASET_SEED);
+			generator.setNameAlphabet(NameAlphabetSkewed);
+			if (!generator.generate(directoryPath, countCountries))
+			{
+				printf("Cannot generate dataset %s\n", directoryPath.c_str());
+			}
+		}
+	};
+
+} // end of EuropeanCountries
+
+/**
+ * Count allocations done by the benchmarked code with operator new.
+ * Blocks allocated with malloc() are not counted.
+ */
+void* operator new(size_t size)
+{
+	EuropeanCountries::gAllocationCount++;
+	return malloc(size);
+}
+
+void* operator new[](size_t size)
+{
+	EuropeanCountries::gAllocationCount++;
+	return malloc(size);
+}
+
+void operator delete(void* pointer)
+{
+	free(pointer);
+}
+
+void operator delete[](void* pointer)
+{
+	free(pointer);
+}
+
+extern "C" int MAMain()
+{
+	MAUtil::Moblet::run(new EuropeanCountries::BenchmarkMoblet());
+	return 0;
+}
+
+#endif /* EC_BENCHMARK */
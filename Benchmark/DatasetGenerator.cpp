@@ -0,0 +1,466 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file DatasetGenerator.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Generates synthetic country datasets with the same schema as
+ * the LocalFiles directory.
+ * Compiled only if EC_BENCHMARK is defined.
+ */
+
+#ifdef EC_BENCHMARK
+
+#define COUNT_LETTERS 26
+#define NUMBER_BUF_SIZE 32
+
+#define COUNTRY_TABLE_FILE_NAME "CountryTable"
+#define COUNTRY_BUNDLE_FILE_NAME "CountryBundle"
+
+// Flag images from resources have handles in this range.
+#define MIN_FLAG_ID 2
+#define MAX_FLAG_ID 51
+
+#define MAX_POPULATION 150000000
+#define MAX_AREA 800000
+
+#include <conprint.h>
+#include <mastdlib.h>
+
+#include "DatasetGenerator.h"
+#include "../Model/ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Field lengths found in the LocalFiles directory.
+	 */
+	static const int sNameLengths[] =
+	{
+		5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+		7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 8, 8, 8, 9, 9, 10, 10, 10, 10, 10, 11,
+		11, 12, 13, 14, 14, 22
+	};
+
+	static const int sCapitalLengths[] =
+	{
+		4, 4, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+		6, 6, 6, 7, 7, 7, 7, 7, 8, 8, 8, 8, 8, 8, 9, 9, 9, 9, 9, 10, 10, 10,
+		10, 10, 12, 16, 18
+	};
+
+	static const int sLanguagesLengths[] =
+	{
+		8, 9, 9, 15, 39, 77, 95, 112, 115, 122, 125, 135, 168, 234, 254, 274,
+		284, 290, 293, 304, 316, 317, 325, 342, 360, 392, 404, 422, 456, 489,
+		513, 520, 567, 570, 587, 614, 626, 678, 718, 724, 730, 757, 781, 805,
+		839, 863, 889, 986, 1039, 1087
+	};
+
+	static const int sGovernmentLengths[] =
+	{
+		83, 166, 206, 258, 309, 317, 377, 382, 386, 387, 395, 398, 401, 447,
+		449, 467, 508, 524, 545, 548, 548, 550, 552, 575, 585, 589, 597, 599,
+		643, 651, 653, 675, 707, 713, 732, 748, 752, 809, 819, 837, 864, 885,
+		891, 904, 975, 1006, 1033, 1039, 1110, 1158
+	};
+
+	/**
+	 * Syllables used to create names.
+	 */
+	static const char* sSyllables[] =
+	{
+		"an", "ber", "ca", "dor", "en", "gar", "ia", "ko", "lan", "ma",
+		"nia", "or", "pol", "ra", "sta", "tin", "u", "va", "we", "zo"
+	};
+
+	/**
+	 * Words used to create texts.
+	 */
+	static const char* sWords[] =
+	{
+		"the", "state", "is", "a", "parliamentary", "republic", "of", "and",
+		"official", "language", "languages", "spoken", "by", "minority",
+		"president", "government", "head", "federal", "constitution", "in",
+		"executive", "power", "legislative", "vested", "assembly", "with",
+		"national", "regional", "recognised", "council", "minister", "prime",
+		"elected", "citizens", "monarchy", "European", "Union", "since"
+	};
+
+	#define COUNT_OF(array) ((int)(sizeof(array) / sizeof(array[0])))
+
+	/**
+	 * Constructor.
+	 * @param seed Seed for the random number generator.
+	 */
+	DatasetGenerator::DatasetGenerator(const int seed):
+		mRandomState(seed),
+		mNameAlphabet(NameAlphabetUniform),
+		mOutputMode(DatasetOutputModeFiles)
+	{
+		// The generator must not start from zero.
+		if (mRandomState == 0)
+		{
+			mRandomState = 1;
+		}
+	}
+
+	/**
+	 * Set the distribution of the name's first letter.
+	 * Default value is NameAlphabetUniform.
+	 * @param nameAlphabet Distribution to use.
+	 */
+	void DatasetGenerator::setNameAlphabet(const NameAlphabet nameAlphabet)
+	{
+		mNameAlphabet = nameAlphabet;
+	}
+
+	/**
+	 * Set the output format.
+	 * Default value is DatasetOutputModeFiles.
+	 * @param outputMode Output format.
+	 */
+	void DatasetGenerator::setOutputMode(const DatasetOutputMode outputMode)
+	{
+		mOutputMode = outputMode;
+	}
+
+	/**
+	 * Generate a dataset.
+	 * @param directoryPath Directory where files will be written.
+	 * It will be created if needed. Must end with a path separator.
+	 * @param countCountries Number of countries to generate.
+	 * @return true if all files were written, false otherwise.
+	 */
+	bool DatasetGenerator::generate(
+		const MAUtil::String& directoryPath,
+		const int countCountries)
+	{
+		// Create the directory.
+		MAHandle directory = maFileOpen(directoryPath.c_str(), MA_ACCESS_READ_WRITE);
+		if (directory < 0)
+		{
+			printf("Cannot open directory %s\n", directoryPath.c_str());
+			return false;
+		}
+		if (!maFileExists(directory))
+		{
+			maFileCreate(directory);
+		}
+		maFileClose(directory);
+
+		// CountryTable file, or the bundle file.
+		MAUtil::String mainFilePath = directoryPath;
+		if (mOutputMode == DatasetOutputModeBundle)
+		{
+			mainFilePath += COUNTRY_BUNDLE_FILE_NAME;
+		}
+		else
+		{
+			mainFilePath += COUNTRY_TABLE_FILE_NAME;
+		}
+		MAHandle mainFile = openFileForWriting(mainFilePath);
+		if (mainFile < 0)
+		{
+			return false;
+		}
+
+		MAUtil::String header("{\n\t\"");
+		header += sCountriesKey;
+		header += "\" :\n\t[\n";
+		bool success = this->writeText(mainFile, header);
+
+		// Names are generated sorted by their first letter, as in CountryTable.
+		int letterCounts[COUNT_LETTERS];
+		this->computeLetterCounts(countCountries, letterCounts);
+
+		int index = 0;
+		for (int letter = 0; success && letter < COUNT_LETTERS; letter++)
+		{
+			for (int i = 0; success && i < letterCounts[letter]; i++)
+			{
+				MAUtil::String fileName;
+				MAUtil::String json;
+				this->createCountry('A' + letter, index, fileName, json);
+
+				MAUtil::String entry(index == 0 ? "\t" : ",\n\t");
+				if (mOutputMode == DatasetOutputModeBundle)
+				{
+					entry += json;
+				}
+				else
+				{
+					entry += "\"";
+					entry += fileName;
+					entry += "\"";
+
+					MAHandle countryFile =
+						openFileForWriting(directoryPath + fileName);
+					success = countryFile >= 0 && this->writeText(countryFile, json);
+					if (countryFile >= 0)
+					{
+						maFileClose(countryFile);
+					}
+				}
+
+				success = success && this->writeText(mainFile, entry);
+				index++;
+			}
+		}
+
+		success = success && this->writeText(mainFile, "\n\t]\n}");
+		maFileClose(mainFile);
+		return success;
+	}
+
+	/**
+	 * Compute how many names start with each letter.
+	 * @param countCountries Number of names.
+	 * @param letterCounts Array of 26 elements that will be filled.
+	 */
+	void DatasetGenerator::computeLetterCounts(
+		const int countCountries,
+		int* letterCounts)
+	{
+		// Weight of each letter.
+		int weights[COUNT_LETTERS];
+		int sumWeights = 0;
+		for (int letter = 0; letter < COUNT_LETTERS; letter++)
+		{
+			switch (mNameAlphabet)
+			{
+			case NameAlphabetSkewed:
+				// Zipf distribution over a shuffled letter order.
+				weights[letter] = 1000 / (1 + (letter * 7) % COUNT_LETTERS);
+				break;
+			case NameAlphabetSingleLetter:
+				weights[letter] = letter == 0 ? 1 : 0;
+				break;
+			default:
+				weights[letter] = 1;
+				break;
+			}
+			sumWeights += weights[letter];
+			letterCounts[letter] = 0;
+		}
+
+		// Pick a letter for each name.
+		for (int i = 0; i < countCountries; i++)
+		{
+			int value = this->nextRandom() % sumWeights;
+			int letter = 0;
+			while (value >= weights[letter])
+			{
+				value -= weights[letter];
+				letter++;
+			}
+			letterCounts[letter]++;
+		}
+	}
+
+	/**
+	 * Create a country JSON object.
+	 * @param firstLetter First letter of the country's name.
+	 * @param index Country index, used to make the file name unique.
+	 * @param outFileName Will contain the country file name.
+	 * @param outJSON Will contain the JSON object.
+	 */
+	void DatasetGenerator::createCountry(
+		const char firstLetter,
+		const int index,
+		MAUtil::String& outFileName,
+		MAUtil::String& outJSON)
+	{
+		MAUtil::String name = this->createName(
+			firstLetter, this->pickValue(sNameLengths, COUNT_OF(sNameLengths)));
+
+		// Random values are read into locals, because the evaluation order
+		// of function arguments is not specified.
+		char capitalLetter = 'A' + this->nextRandom() % COUNT_LETTERS;
+		int capitalLength =
+			this->pickValue(sCapitalLengths, COUNT_OF(sCapitalLengths));
+		MAUtil::String capital = this->createName(capitalLetter, capitalLength);
+		MAUtil::String languages = this->createText(
+			this->pickValue(sLanguagesLengths, COUNT_OF(sLanguagesLengths)));
+		MAUtil::String government = this->createText(
+			this->pickValue(sGovernmentLengths, COUNT_OF(sGovernmentLengths)));
+		int flagID = MIN_FLAG_ID +
+			this->nextRandom() % (MAX_FLAG_ID - MIN_FLAG_ID + 1);
+
+		// Some areas are small and have decimals, like Vatican City.
+		MAUtil::String area;
+		if (this->nextRandom() % 10 == 0)
+		{
+			int integerPart = this->nextRandom() % 500;
+			int decimalPart = this->nextRandom() % 100;
+			char buf[NUMBER_BUF_SIZE];
+			sprintf(buf, "%d.%02d", integerPart, decimalPart);
+			area = buf;
+		}
+		else
+		{
+			area = this->formatNumber(this->nextRandom() % MAX_AREA);
+		}
+		area += " sq km";
+
+		// File name must be unique and cannot contain spaces.
+		char indexBuf[NUMBER_BUF_SIZE];
+		sprintf(indexBuf, "_%d", index);
+		outFileName = name;
+		outFileName += indexBuf;
+
+		char flagBuf[NUMBER_BUF_SIZE];
+		sprintf(flagBuf, "%d", flagID);
+
+		outJSON = "{\n\t\"";
+		outJSON += sCountryNameKey;
+		outJSON += "\" : \"" + name + "\",\n\t\"";
+		outJSON += sCountryFlagIDKey;
+		outJSON += "\": ";
+		outJSON += flagBuf;
+		outJSON += ",\n\t\"";
+		outJSON += sCountryPopulationKey;
+		outJSON += "\" : \"" +
+			this->formatNumber(this->nextRandom() % MAX_POPULATION) + "\",\n\t\"";
+		outJSON += sCountryAreaKey;
+		outJSON += "\" : \"" + area + "\",\n\t\"";
+		outJSON += sCountryLanguagesKey;
+		outJSON += "\" : \"" + languages + "\",\n\t\"";
+		outJSON += sCountryGovernmentKey;
+		outJSON += "\" : \"" + government + "\",\n\t\"";
+		outJSON += sCountryCapitalKey;
+		outJSON += "\" : \"" + capital + "\"\n}";
+	}
+
+	/**
+	 * Create a random word-like name.
+	 * @param firstLetter Name's first letter.
+	 * @param length Name length.
+	 * @return The name.
+	 */
+	MAUtil::String DatasetGenerator::createName(
+		const char firstLetter,
+		const int length)
+	{
+		MAUtil::String name;
+		name += firstLetter;
+		while (name.length() < length)
+		{
+			name += sSyllables[this->nextRandom() % COUNT_OF(sSyllables)];
+		}
+		name.resize(length);
+		return name;
+	}
+
+	/**
+	 * Create random text made of sentences.
+	 * @param length Approximate text length.
+	 * @return The text.
+	 */
+	MAUtil::String DatasetGenerator::createText(const int length)
+	{
+		MAUtil::String text;
+		text.reserve(length + 16);
+		bool sentenceStart = true;
+		while (text.length() < length)
+		{
+			if (text.length() > 0)
+			{
+				text += " ";
+			}
+
+			MAUtil::String word = sWords[this->nextRandom() % COUNT_OF(sWords)];
+			if (sentenceStart)
+			{
+				word[0] = toupper(word[0]);
+			}
+			text += word;
+
+			// End the sentence after about ten words.
+			sentenceStart = this->nextRandom() % 10 == 0;
+			if (sentenceStart || text.length() >= length)
+			{
+				text += ".";
+			}
+		}
+		return text;
+	}
+
+	/**
+	 * Format a number using comma as thousands separator.
+	 * @param value Value to format.
+	 * @return Formatted value.
+	 */
+	MAUtil::String DatasetGenerator::formatNumber(const int value)
+	{
+		char buf[NUMBER_BUF_SIZE];
+		sprintf(buf, "%d", value);
+		int countDigits = strlen(buf);
+
+		MAUtil::String result;
+		for (int i = 0; i < countDigits; i++)
+		{
+			if (i > 0 && (countDigits - i) % 3 == 0)
+			{
+				result += ",";
+			}
+			result += buf[i];
+		}
+		return result;
+	}
+
+	/**
+	 * Pick a random value from an array.
+	 * @param values Array of values.
+	 * @param countValues Number of elements in the array.
+	 * @return One of the values.
+	 */
+	int DatasetGenerator::pickValue(const int* values, const int countValues)
+	{
+		return values[this->nextRandom() % countValues];
+	}
+
+	/**
+	 * Get the next random number.
+	 * Uses a xorshift generator, so results do not depend on the platform.
+	 * @return A value in the [0, 2^31) range.
+	 */
+	int DatasetGenerator::nextRandom()
+	{
+		mRandomState ^= mRandomState << 13;
+		mRandomState ^= mRandomState >> 17;
+		mRandomState ^= mRandomState << 5;
+		return (int) (mRandomState & 0x7FFFFFFF);
+	}
+
+	/**
+	 * Write text to an open file.
+	 * @param file File handle.
+	 * @param text Text to write.
+	 * @return true on success, false otherwise.
+	 */
+	bool DatasetGenerator::writeText(MAHandle file, const MAUtil::String& text)
+	{
+		return maFileWrite(file, text.c_str(), text.length()) == 0;
+	}
+
+} // end of EuropeanCountries
+
+#endif /* EC_BENCHMARK */
@@ -0,0 +1,191 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file DatasetGenerator.h
+ * @author Bogdan Iusco
+ *
+ * @brief Generates synthetic country datasets with the same schema as
+ * the LocalFiles directory.
+ * Compiled only if EC_BENCHMARK is defined.
+ */
+
+#ifndef EC_DATASET_GENERATOR_H_
+#define EC_DATASET_GENERATOR_H_
+
+#include <maapi.h>
+#include <MAUtil/String.h>
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Distribution of the first letter of generated country names.
+	 * The first letter decides the sections created by CountriesListScreen.
+	 */
+	enum NameAlphabet
+	{
+		// First letters are evenly spread over A-Z.
+		NameAlphabetUniform = 0,
+		// Few letters are used by most of the names(Zipf distribution).
+		NameAlphabetSkewed,
+		// All names start with the same letter.
+		NameAlphabetSingleLetter
+	};
+
+	/**
+	 * Output format for generated datasets.
+	 */
+	enum DatasetOutputMode
+	{
+		// A CountryTable file and one JSON file for each country.
+		DatasetOutputModeFiles = 0,
+		// A single CountryBundle file with all countries in a JSON array.
+		DatasetOutputModeBundle
+	};
+
+	/**
+	 * @brief Writes a CountryTable file and country files that can be read
+	 * by DatabaseManager.
+	 * Field lengths are picked from the lengths found in the LocalFiles
+	 * directory. The same seed always generates the same dataset.
+	 */
+	class DatasetGenerator
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param seed Seed for the random number generator.
+		 */
+		DatasetGenerator(const int seed);
+
+		/**
+		 * Set the distribution of the name's first letter.
+		 * Default value is NameAlphabetUniform.
+		 * @param nameAlphabet Distribution to use.
+		 */
+		void setNameAlphabet(const NameAlphabet nameAlphabet);
+
+		/**
+		 * Set the output format.
+		 * Default value is DatasetOutputModeFiles.
+		 * @param outputMode Output format.
+		 */
+		void setOutputMode(const DatasetOutputMode outputMode);
+
+		/**
+		 * Generate a dataset.
+		 * @param directoryPath Directory where files will be written.
+		 * It will be created if needed. Must end with a path separator.
+		 * @param countCountries Number of countries to generate.
+		 * @return true if all files were written, false otherwise.
+		 */
+		bool generate(
+			const MAUtil::String& directoryPath,
+			const int countCountries);
+
+	private:
+		/**
+		 * Compute how many names start with each letter.
+		 * @param countCountries Number of names.
+		 * @param letterCounts Array of 26 elements that will be filled.
+		 */
+		void computeLetterCounts(
+			const int countCountries,
+			int* letterCounts);
+
+		/**
+		 * Create a country JSON object.
+		 * @param firstLetter First letter of the country's name.
+		 * @param index Country index, used to make the file name unique.
+		 * @param outFileName Will contain the country file name.
+		 * @param outJSON Will contain the JSON object.
+		 */
+		void createCountry(
+			const char firstLetter,
+			const int index,
+			MAUtil::String& outFileName,
+			MAUtil::String& outJSON);
+
+		/**
+		 * Create a random word-like name.
+		 * @param firstLetter Name's first letter.
+		 * @param length Name length.
+		 * @return The name.
+		 */
+		MAUtil::String createName(
+			const char firstLetter,
+			const int length);
+
+		/**
+		 * Create random text made of sentences.
+		 * @param length Approximate text length.
+		 * @return The text.
+		 */
+		MAUtil::String createText(const int length);
+
+		/**
+		 * Format a number using comma as thousands separator.
+		 * @param value Value to format.
+		 * @return Formatted value.
+		 */
+		MAUtil::String formatNumber(const int value);
+
+		/**
+		 * Pick a random value from an array.
+		 * @param values Array of values.
+		 * @param countValues Number of elements in the array.
+		 * @return One of the values.
+		 */
+		int pickValue(const int* values, const int countValues);
+
+		/**
+		 * Get the next random number.
+		 * @return A value in the [0, 2^31) range.
+		 */
+		int nextRandom();
+
+		/**
+		 * Write text to an open file.
+		 * @param file File handle.
+		 * @param text Text to write.
+		 * @return true on success, false otherwise.
+		 */
+		bool writeText(MAHandle file, const MAUtil::String& text);
+
+	private:
+		/**
+		 * State of the random number generator.
+		 */
+		unsigned int mRandomState;
+
+		/**
+		 * Distribution of the name's first letter.
+		 */
+		NameAlphabet mNameAlphabet;
+
+		/**
+		 * Output format.
+		 */
+		DatasetOutputMode mOutputMode;
+
+	}; // end of DatasetGenerator
+
+} // end of EuropeanCountries
+
+#endif /* EC_DATASET_GENERATOR_H_ */
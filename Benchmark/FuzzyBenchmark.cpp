@@ -0,0 +1,162 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file FuzzyBenchmark.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Times the fuzzy name search of the database.
+ * Compiled only if EC_BENCHMARK is defined.
+ */
+
+#ifdef EC_BENCHMARK
+
+#define BUNDLED_DATASET_NAME "LocalFiles"
+#define FUZZY_MAX_RESULTS 5
+
+#include <conprint.h>
+#include <mastdlib.h>
+
+#include "FuzzyBenchmark.h"
+#include "../Model/CountrySummaryTable.h"
+#include "../Model/DatabaseManager.h"
+#include "../Model/LocalFileReader.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Misspelled names searched in each dataset.
+	 */
+	static const char* sSearchedTexts[] =
+	{
+		"Chech Republic",
+		"Bosnia",
+		"Macedona",
+		"Lubljana",
+		"swizerland",
+		"Hersegovina"
+	};
+
+	/**
+	 * Constructor.
+	 * @param iterations How many times each text is searched.
+	 */
+	FuzzyBenchmark::FuzzyBenchmark(const int iterations):
+		mIterations(iterations)
+	{
+		if (mIterations < 1)
+		{
+			mIterations = 1;
+		}
+	}
+
+	/**
+	 * Add a dataset that will be searched by run().
+	 * The bundled LocalFiles dataset is always searched first.
+	 * @param name Dataset name used in printed results.
+	 * @param directoryPath Directory that contains the CountryTable file
+	 * and country files. Must end with a path separator.
+	 */
+	void FuzzyBenchmark::addDataset(
+		const MAUtil::String& name,
+		const MAUtil::String& directoryPath)
+	{
+		mDatasetNames.add(name);
+		mDatasetPaths.add(directoryPath);
+	}
+
+	/**
+	 * Search all datasets and print the results.
+	 */
+	void FuzzyBenchmark::run()
+	{
+		printf("Fuzzy benchmark, %d iterations per text\n", mIterations);
+
+		DatabaseManager bundledDatabase;
+		bundledDatabase.readDataFromFiles();
+		this->runDatabase(BUNDLED_DATASET_NAME, bundledDatabase);
+
+		for (int index = 0; index < mDatasetNames.size(); index++)
+		{
+			LocalFileReader fileReader(mDatasetPaths[index]);
+			DatabaseManager database(fileReader);
+			database.readDataFromFiles();
+			this->runDatabase(mDatasetNames[index], database);
+		}
+	}
+
+	/**
+	 * Search the texts in a loaded database and print the results.
+	 * @param name Dataset name.
+	 * @param database Database that contains the dataset.
+	 */
+	void FuzzyBenchmark::runDatabase(
+		const MAUtil::String& name,
+		DatabaseManager& database)
+	{
+		int countCountries = database.countCountries();
+		if (countCountries == 0)
+		{
+			printf("%s: no countries loaded\n", name.c_str());
+			return;
+		}
+
+		// The first search builds the trigram index.
+		MAUtil::Vector<CountryFuzzyMatch> matches;
+		int startTime = maGetMilliSecondCount();
+		database.findCountriesFuzzy(sSearchedTexts[0], FUZZY_MAX_RESULTS,
+			matches);
+		printf("%s: %d countries, index built in %d ms\n",
+			name.c_str(), countCountries, maGetMilliSecondCount() - startTime);
+
+		const CountrySummaryTable& summaryTable = database.getSummaryTable();
+		int countTexts = sizeof(sSearchedTexts) / sizeof(sSearchedTexts[0]);
+		for (int index = 0; index < countTexts; index++)
+		{
+			MAUtil::String text = sSearchedTexts[index];
+
+			startTime = maGetMilliSecondCount();
+			for (int iteration = 0; iteration < mIterations; iteration++)
+			{
+				database.findCountriesFuzzy(text, FUZZY_MAX_RESULTS, matches);
+			}
+			int searchTime = maGetMilliSecondCount() - startTime;
+
+			const char* bestMatch = "-";
+			int distance = -1;
+			if (matches.size() > 0)
+			{
+				int countryID = matches[0].countryID;
+				bestMatch = matches[0].field == CountrySearchCapital ?
+					summaryTable.getCapital(countryID).text :
+					summaryTable.getName(countryID).text;
+				distance = matches[0].distance;
+			}
+			printf("  \"%s\": %d found in %d us, best \"%s\"(distance %d)\n",
+				text.c_str(),
+				matches.size(),
+				(int) (searchTime * 1000.0 / mIterations),
+				bestMatch,
+				distance);
+		}
+	}
+
+} // end of EuropeanCountries
+
+#endif /* EC_BENCHMARK */
@@ -0,0 +1,99 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file FuzzyBenchmark.h
+ * @author Bogdan Iusco
+ *
+ * @brief Times the fuzzy name search of the database.
+ * Compiled only if EC_BENCHMARK is defined.
+ */
+
+#ifndef EC_FUZZY_BENCHMARK_H_
+#define EC_FUZZY_BENCHMARK_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	// Forward declarations for EuropeanCountries namespace classes.
+	class DatabaseManager;
+
+	/**
+	 * @brief Searches several misspelled names in each dataset with
+	 * DatabaseManager::findCountriesFuzzy() and prints the time of each
+	 * search and the best match.
+	 */
+	class FuzzyBenchmark
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param iterations How many times each text is searched.
+		 */
+		FuzzyBenchmark(const int iterations);
+
+		/**
+		 * Add a dataset that will be searched by run().
+		 * The bundled LocalFiles dataset is always searched first.
+		 * @param name Dataset name used in printed results.
+		 * @param directoryPath Directory that contains the CountryTable file
+		 * and country files. Must end with a path separator.
+		 */
+		void addDataset(
+			const MAUtil::String& name,
+			const MAUtil::String& directoryPath);
+
+		/**
+		 * Search all datasets and print the results.
+		 */
+		void run();
+
+	private:
+		/**
+		 * Search the texts in a loaded database and print the results.
+		 * @param name Dataset name.
+		 * @param database Database that contains the dataset.
+		 */
+		void runDatabase(
+			const MAUtil::String& name,
+			DatabaseManager& database);
+
+	private:
+		/**
+		 * How many times each text is searched.
+		 */
+		int mIterations;
+
+		/**
+		 * Names of the datasets added with addDataset().
+		 */
+		MAUtil::Vector<MAUtil::String> mDatasetNames;
+
+		/**
+		 * Directories of the datasets added with addDataset().
+		 */
+		MAUtil::Vector<MAUtil::String> mDatasetPaths;
+
+	}; // end of FuzzyBenchmark
+
+} // end of EuropeanCountries
+
+#endif /* EC_FUZZY_BENCHMARK_H_ */
@@ -0,0 +1,431 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file LoadBenchmark.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Measures the time needed to load the database from several
+ * datasets.
+ * Compiled only if EC_BENCHMARK is defined.
+ */
+
+#ifdef EC_BENCHMARK
+
+#define BUNDLED_DATASET_NAME "LocalFiles"
+#define SNAPSHOT_FILE_NAME "BenchmarkSnapshot"
+#define COUNTRY_TABLE_FILE_NAME "CountryTable"
+
+// Handle of the LocalFiles.bin resource(first entry in Resources.lst).
+#define LOCAL_FILES_RESOURCE 1
+
+#include <conprint.h>
+#include <mastdlib.h>
+#include <Wormhole/FileUtil.h>
+
+#include "LoadBenchmark.h"
+#include "../Model/BundleFileReader.h"
+#include "../Model/Country.h"
+#include "../Model/CountryParser.h"
+#include "../Model/DatabaseManager.h"
+#include "../Model/LocalFileReader.h"
+#include "../Model/StringArena.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Numbers of files per load job used by runJobSizes().
+	 */
+	static const int sJobSizes[] = { 1, 16, 256, 4096 };
+
+	/**
+	 * @brief Keeps a copy of each file of a batch, so that the files can
+	 * be parsed after they were read.
+	 */
+	class FileContentsCollector:
+		public IFileBatchListener
+	{
+	public:
+		/**
+		 * Copy a file of the batch. Files that cannot be read are skipped.
+		 * From IFileBatchListener.
+		 * @param index Index of the file in the file names array.
+		 * @param content File content, or NULL if the file could not
+		 * be read.
+		 * @param size Content size in bytes.
+		 */
+		virtual void fileRead(
+			const int index,
+			const char* content,
+			const int size)
+		{
+			if (content)
+			{
+				contents.add(MAUtil::String(content, size));
+			}
+		}
+
+		/**
+		 * Contents of the files that were read.
+		 */
+		MAUtil::Vector<MAUtil::String> contents;
+
+	}; // end of FileContentsCollector
+
+	/**
+	 * Constructor.
+	 * @param iterations How many times each dataset will be loaded.
+	 */
+	LoadBenchmark::LoadBenchmark(const int iterations):
+		mIterations(iterations)
+	{
+		if (mIterations < 1)
+		{
+			mIterations = 1;
+		}
+	}
+
+	/**
+	 * Destructor.
+	 */
+	LoadBenchmark::~LoadBenchmark()
+	{
+		mDatasetNames.clear();
+		mDatasetPaths.clear();
+	}
+
+	/**
+	 * Add a dataset that will be loaded by run().
+	 * The bundled LocalFiles dataset is always loaded first.
+	 * @param name Dataset name used in printed results.
+	 * @param directoryPath Directory that contains the CountryTable file
+	 * and country files. Must end with a path separator.
+	 */
+	void LoadBenchmark::addDataset(
+		const MAUtil::String& name,
+		const MAUtil::String& directoryPath)
+	{
+		mDatasetNames.add(name);
+		mDatasetPaths.add(directoryPath);
+	}
+
+	/**
+	 * Load all datasets and print the results.
+	 */
+	void LoadBenchmark::run()
+	{
+		printf("Load benchmark, %d iterations per dataset\n", mIterations);
+		this->runBundledDataset();
+		for (int index = 0; index < mDatasetNames.size(); index++)
+		{
+			this->runDataset(mDatasetNames[index], mDatasetPaths[index]);
+		}
+	}
+
+	/**
+	 * Load a dataset with several load job sizes and print the
+	 * load time of each size.
+	 * @param name Dataset name used in printed results.
+	 * @param directoryPath Directory that contains the CountryTable file
+	 * and country files. Must end with a path separator.
+	 */
+	void LoadBenchmark::runJobSizes(
+		const MAUtil::String& name,
+		const MAUtil::String& directoryPath)
+	{
+		printf("%s: load job sizes, %d iterations per size\n",
+			name.c_str(), mIterations);
+
+		LocalFileReader fileReader(directoryPath);
+		int countSizes = sizeof(sJobSizes) / sizeof(sJobSizes[0]);
+		for (int index = 0; index < countSizes; index++)
+		{
+			LoadStatistics sum;
+			int allocations = 0;
+			for (int iteration = 0; iteration < mIterations; iteration++)
+			{
+				DatabaseManager database(fileReader);
+				database.setLoadJobSize(sJobSizes[index]);
+				this->loadDatabase(database, sum, allocations);
+			}
+			if (sum.countCountries == 0)
+			{
+				printf("  no countries loaded\n");
+				return;
+			}
+			printf("  %4d files per job: %d ms, "
+				"%d operator new calls/country\n",
+				sJobSizes[index],
+				sum.countryFilesTime / mIterations,
+				allocations / sum.countCountries);
+		}
+	}
+
+	/**
+	 * Load the bundled LocalFiles dataset and print the results.
+	 * Files are read directly from LocalFiles.bin, then from the cache file.
+	 */
+	void LoadBenchmark::runBundledDataset()
+	{
+		LoadStatistics sum;
+		int allocations = 0;
+		for (int iteration = 0; iteration < mIterations; iteration++)
+		{
+			DatabaseManager database;
+			database.setCacheEnabled(false);
+			this->loadDatabase(database, sum, allocations);
+		}
+		this->printResult(BUNDLED_DATASET_NAME, sum, allocations);
+
+		BundleFileReader bundleReader(LOCAL_FILES_RESOURCE);
+		this->runParsing(BUNDLED_DATASET_NAME, bundleReader);
+
+		// The first load writes the cache file if it is missing.
+		DatabaseManager cacheDatabase;
+		cacheDatabase.readDataFromFiles();
+		LoadStatistics cacheSum;
+		int cacheAllocations = 0;
+		for (int iteration = 0; iteration < mIterations; iteration++)
+		{
+			DatabaseManager database;
+			this->loadDatabase(database, cacheSum, cacheAllocations);
+		}
+		this->printResult(MAUtil::String(BUNDLED_DATASET_NAME) + " cache",
+			cacheSum, cacheAllocations);
+
+		Wormhole::FileUtil fileUtil;
+		DatabaseManager database;
+		database.readDataFromFiles();
+		this->runSnapshot(BUNDLED_DATASET_NAME, database,
+			fileUtil.getLocalPath() + SNAPSHOT_FILE_NAME);
+	}
+
+	/**
+	 * Load a dataset from a given directory and print the results.
+	 * @param name Dataset name.
+	 * @param directoryPath Directory that contains the dataset.
+	 */
+	void LoadBenchmark::runDataset(
+		const MAUtil::String& name,
+		const MAUtil::String& directoryPath)
+	{
+		LocalFileReader fileReader(directoryPath);
+		LoadStatistics sum;
+		int allocations = 0;
+		for (int iteration = 0; iteration < mIterations; iteration++)
+		{
+			DatabaseManager database(fileReader);
+			this->loadDatabase(database, sum, allocations);
+		}
+		this->printResult(name, sum, allocations);
+		this->runParsing(name, fileReader);
+
+		DatabaseManager database(fileReader);
+		database.readDataFromFiles();
+		this->runSnapshot(name, database, directoryPath + SNAPSHOT_FILE_NAME);
+	}
+
+	/**
+	 * Read all country files of a dataset, then parse them from memory
+	 * and print the parse time.
+	 * The load jobs parse each file as soon as it is read, so the load
+	 * statistics cannot tell the parse time from the read time.
+	 * @param name Dataset name.
+	 * @param fileReader Used to read the dataset.
+	 */
+	void LoadBenchmark::runParsing(
+		const MAUtil::String& name,
+		IFileReader& fileReader)
+	{
+		MAUtil::String countryTable;
+		MAUtil::Vector<MAUtil::String> fileNames;
+		StringArena tableArena;
+		CountryParser tableParser(tableArena);
+		if (!fileReader.readTextFromFile(COUNTRY_TABLE_FILE_NAME,
+				countryTable) ||
+			!tableParser.parseCountryTable(countryTable.c_str(),
+				countryTable.size(), fileNames))
+		{
+			printf("%s: cannot read CountryTable\n", name.c_str());
+			return;
+		}
+
+		FileContentsCollector collector;
+		fileReader.readTextFromFiles(fileNames, 0, fileNames.size(),
+			collector);
+		const MAUtil::Vector<MAUtil::String>& contents = collector.contents;
+		double bytes = 0;
+		for (int index = 0; index < contents.size(); index++)
+		{
+			bytes += contents[index].size();
+		}
+
+		int parseTime = 0;
+		for (int iteration = 0; iteration < mIterations; iteration++)
+		{
+			StringArena stringArena;
+			CountryParser countryParser(stringArena);
+			int startTime = maGetMilliSecondCount();
+			for (int index = 0; index < contents.size(); index++)
+			{
+				Country country(index);
+				countryParser.parseCountry(contents[index].c_str(),
+					contents[index].size(), country, CountrySummaryFields);
+			}
+			parseTime += maGetMilliSecondCount() - startTime;
+		}
+
+		double bytesPerSecond = 0;
+		if (parseTime > 0)
+		{
+			bytesPerSecond = bytes * mIterations * 1000.0 / parseTime;
+		}
+		printf("%s: %d country files parsed from memory in %d ms, "
+			"%d KB/s\n",
+			name.c_str(),
+			contents.size(),
+			parseTime / mIterations,
+			(int) (bytesPerSecond / 1024));
+	}
+
+	/**
+	 * Write a snapshot image with the data of a given database, then
+	 * load the snapshot and print the results.
+	 * @param name Dataset name.
+	 * @param database Database that contains the dataset.
+	 * @param snapshotPath Path of the snapshot file.
+	 */
+	void LoadBenchmark::runSnapshot(
+		const MAUtil::String& name,
+		DatabaseManager& database,
+		const MAUtil::String& snapshotPath)
+	{
+		if (database.countCountries() == 0)
+		{
+			return;
+		}
+
+		int startTime = maGetMilliSecondCount();
+		if (!database.writeSnapshot(snapshotPath))
+		{
+			printf("%s: cannot write snapshot\n", name.c_str());
+			return;
+		}
+		printf("%s: snapshot written in %d ms\n",
+			name.c_str(), maGetMilliSecondCount() - startTime);
+
+		LoadStatistics sum;
+		int allocations = 0;
+		for (int iteration = 0; iteration < mIterations; iteration++)
+		{
+			DatabaseManager snapshotDatabase;
+			int allocationsBefore = gAllocationCount;
+			snapshotDatabase.readDataFromSnapshot(snapshotPath);
+			allocations += gAllocationCount - allocationsBefore;
+			this->addStatistics(snapshotDatabase, sum);
+		}
+		this->printResult(name + " snapshot", sum, allocations);
+	}
+
+	/**
+	 * Load a database and add its statistics to given values.
+	 * @param database Database to load.
+	 * @param sum Statistics will be added to this value.
+	 * @param allocations Number of allocations will be added to this value.
+	 */
+	void LoadBenchmark::loadDatabase(
+		DatabaseManager& database,
+		LoadStatistics& sum,
+		int& allocations)
+	{
+		int allocationsBefore = gAllocationCount;
+		database.readDataFromFiles();
+		allocations += gAllocationCount - allocationsBefore;
+		this->addStatistics(database, sum);
+	}
+
+	/**
+	 * Add the statistics of the last load operation to given values.
+	 * @param database Database that was loaded.
+	 * @param sum Statistics will be added to this value.
+	 */
+	void LoadBenchmark::addStatistics(
+		const DatabaseManager& database,
+		LoadStatistics& sum)
+	{
+		const LoadStatistics& statistics = database.getLoadStatistics();
+		sum.extractTime += statistics.extractTime;
+		sum.countryTableTime += statistics.countryTableTime;
+		sum.countryFilesTime += statistics.countryFilesTime;
+		sum.totalTime += statistics.totalTime;
+		sum.countCountries += statistics.countCountries;
+		sum.bytesRead += statistics.bytesRead;
+		sum.loadedFromCache = sum.loadedFromCache || statistics.loadedFromCache;
+	}
+
+	/**
+	 * Print the average values for a dataset.
+	 * @param name Dataset name.
+	 * @param sum Statistics summed over all iterations.
+	 * @param allocations Allocations summed over all iterations.
+	 */
+	void LoadBenchmark::printResult(
+		const MAUtil::String& name,
+		const LoadStatistics& sum,
+		const int allocations)
+	{
+		if (sum.countCountries == 0)
+		{
+			printf("%s: no countries loaded\n", name.c_str());
+			return;
+		}
+
+		// Times are summed in milliseconds, use doubles to avoid overflow.
+		double countCountries = sum.countCountries;
+		double nsPerCountry = sum.totalTime * 1000000.0 / countCountries;
+		// The bytes are read and parsed during the whole load, except the
+		// extraction of LocalFiles.bin, which reads other data.
+		double loadTime = sum.totalTime - sum.extractTime;
+		double bytesPerSecond = 0;
+		if (loadTime > 0)
+		{
+			bytesPerSecond = sum.bytesRead * 1000.0 / loadTime;
+		}
+
+		printf("%s: %d countries, %d bytes\n",
+			name.c_str(),
+			sum.countCountries / mIterations,
+			(int) (sum.bytesRead / mIterations));
+		printf("  extractLocalFiles    %d ms\n", sum.extractTime / mIterations);
+		printf("  readCountryTableFile %d ms\n",
+			sum.countryTableTime / mIterations);
+		printf("  continueLoading      %d ms\n",
+			sum.countryFilesTime / mIterations);
+		printf("  total                %d ms%s\n", sum.totalTime / mIterations,
+			sum.loadedFromCache ? " (restored from cache)" : "");
+		printf("  %d ns/country, %d KB/s read and parsed, "
+			"%d operator new calls/country\n",
+			(int) nsPerCountry,
+			(int) (bytesPerSecond / 1024),
+			(int) (allocations / countCountries));
+	}
+
+} // end of EuropeanCountries
+
+#endif /* EC_BENCHMARK */
@@ -0,0 +1,185 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file LoadBenchmark.h
+ * @author Bogdan Iusco
+ *
+ * @brief Measures the time needed to load the database from several
+ * datasets.
+ * Compiled only if EC_BENCHMARK is defined.
+ */
+
+#ifndef EC_LOAD_BENCHMARK_H_
+#define EC_LOAD_BENCHMARK_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+#include "../Model/LoadStatistics.h"
+
+namespace EuropeanCountries
+{
+
+	// Forward declarations for EuropeanCountries namespace classes.
+	class DatabaseManager;
+	class IFileReader;
+
+	/**
+	 * Number of heap allocations done with operator new.
+	 * Blocks allocated with malloc(), e.g. the string arena blocks and
+	 * the snapshot image, are not counted: MoSync has no hook for them.
+	 * Defined by BenchmarkMain.cpp.
+	 */
+	extern int gAllocationCount;
+
+	/**
+	 * @brief Loads the database several times from each dataset and prints
+	 * the average values for each load stage.
+	 */
+	class LoadBenchmark
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param iterations How many times each dataset will be loaded.
+		 */
+		LoadBenchmark(const int iterations);
+
+		/**
+		 * Destructor.
+		 */
+		~LoadBenchmark();
+
+		/**
+		 * Add a dataset that will be loaded by run().
+		 * The bundled LocalFiles dataset is always loaded first.
+		 * @param name Dataset name used in printed results.
+		 * @param directoryPath Directory that contains the CountryTable file
+		 * and country files. Must end with a path separator.
+		 */
+		void addDataset(
+			const MAUtil::String& name,
+			const MAUtil::String& directoryPath);
+
+		/**
+		 * Load all datasets and print the results.
+		 */
+		void run();
+
+		/**
+		 * Load a dataset with several load job sizes and print the
+		 * load time of each size.
+		 * @param name Dataset name used in printed results.
+		 * @param directoryPath Directory that contains the CountryTable file
+		 * and country files. Must end with a path separator.
+		 */
+		void runJobSizes(
+			const MAUtil::String& name,
+			const MAUtil::String& directoryPath);
+
+	private:
+		/**
+		 * Load the bundled LocalFiles dataset and print the results.
+		 * Files are extracted from LocalFiles.bin if needed.
+		 */
+		void runBundledDataset();
+
+		/**
+		 * Load a dataset from a given directory and print the results.
+		 * @param name Dataset name.
+		 * @param directoryPath Directory that contains the dataset.
+		 */
+		void runDataset(
+			const MAUtil::String& name,
+			const MAUtil::String& directoryPath);
+
+		/**
+		 * Read all country files of a dataset, then parse them from memory
+		 * and print the parse time.
+		 * @param name Dataset name.
+		 * @param fileReader Used to read the dataset.
+		 */
+		void runParsing(
+			const MAUtil::String& name,
+			IFileReader& fileReader);
+
+		/**
+		 * Write a snapshot image with the data of a given database, then
+		 * load the snapshot and print the results.
+		 * @param name Dataset name.
+		 * @param database Database that contains the dataset.
+		 * @param snapshotPath Path of the snapshot file.
+		 */
+		void runSnapshot(
+			const MAUtil::String& name,
+			DatabaseManager& database,
+			const MAUtil::String& snapshotPath);
+
+		/**
+		 * Load a database and add its statistics to given values.
+		 * @param database Database to load.
+		 * @param sum Statistics will be added to this value.
+		 * @param allocations Number of allocations will be added to this value.
+		 */
+		void loadDatabase(
+			DatabaseManager& database,
+			LoadStatistics& sum,
+			int& allocations);
+
+		/**
+		 * Add the statistics of the last load operation to given values.
+		 * @param database Database that was loaded.
+		 * @param sum Statistics will be added to this value.
+		 */
+		void addStatistics(
+			const DatabaseManager& database,
+			LoadStatistics& sum);
+
+		/**
+		 * Print the average values for a dataset.
+		 * @param name Dataset name.
+		 * @param sum Statistics summed over all iterations.
+		 * @param allocations Allocations summed over all iterations.
+		 */
+		void printResult(
+			const MAUtil::String& name,
+			const LoadStatistics& sum,
+			const int allocations);
+
+	private:
+		/**
+		 * How many times each dataset is loaded.
+		 */
+		int mIterations;
+
+		/**
+		 * Names of the datasets added with addDataset().
+		 */
+		MAUtil::Vector<MAUtil::String> mDatasetNames;
+
+		/**
+		 * Directories of the datasets added with addDataset().
+		 */
+		MAUtil::Vector<MAUtil::String> mDatasetPaths;
+
+	}; // end of LoadBenchmark
+
+} // end of EuropeanCountries
+
+#endif /* EC_LOAD_BENCHMARK_H_ */
@@ -0,0 +1,196 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file ScanBenchmark.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Compares the text scanner of the database with a strstr() loop
+ * over the country fields.
+ * Compiled only if EC_BENCHMARK is defined.
+ */
+
+#ifdef EC_BENCHMARK
+
+#define BUNDLED_DATASET_NAME "LocalFiles"
+
+#include <conprint.h>
+#include <mastdlib.h>
+
+#include "ScanBenchmark.h"
+#include "../Model/Country.h"
+#include "../Model/DatabaseManager.h"
+#include "../Model/LocalFileReader.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Texts searched in each dataset.
+	 */
+	static const char* sScannedTexts[] =
+	{
+		"an",
+		"Republic",
+		"parliamentary",
+		"19",
+		"(",
+		"land"
+	};
+
+	/**
+	 * Constructor.
+	 * @param iterations How many times each text is searched.
+	 */
+	ScanBenchmark::ScanBenchmark(const int iterations):
+		mIterations(iterations)
+	{
+		if (mIterations < 1)
+		{
+			mIterations = 1;
+		}
+	}
+
+	/**
+	 * Add a dataset that will be searched by run().
+	 * The bundled LocalFiles dataset is always searched first.
+	 * @param name Dataset name used in printed results.
+	 * @param directoryPath Directory that contains the CountryTable file
+	 * and country files. Must end with a path separator.
+	 */
+	void ScanBenchmark::addDataset(
+		const MAUtil::String& name,
+		const MAUtil::String& directoryPath)
+	{
+		mDatasetNames.add(name);
+		mDatasetPaths.add(directoryPath);
+	}
+
+	/**
+	 * Search all datasets and print the results.
+	 */
+	void ScanBenchmark::run()
+	{
+		printf("Scan benchmark, %d iterations per text\n", mIterations);
+
+		DatabaseManager bundledDatabase;
+		bundledDatabase.readDataFromFiles();
+		this->runDatabase(BUNDLED_DATASET_NAME, bundledDatabase);
+
+		for (int index = 0; index < mDatasetNames.size(); index++)
+		{
+			LocalFileReader fileReader(mDatasetPaths[index]);
+			DatabaseManager database(fileReader);
+			database.readDataFromFiles();
+			this->runDatabase(mDatasetNames[index], database);
+		}
+	}
+
+	/**
+	 * Search the texts in a loaded database and print the results.
+	 * @param name Dataset name.
+	 * @param database Database that contains the dataset.
+	 */
+	void ScanBenchmark::runDatabase(
+		const MAUtil::String& name,
+		DatabaseManager& database)
+	{
+		int countCountries = database.countCountries();
+		if (countCountries == 0)
+		{
+			printf("%s: no countries loaded\n", name.c_str());
+			return;
+		}
+
+		// The strstr() loop reads the fields from the Country objects.
+		MAUtil::Vector<MAUtil::String> fields;
+		fields.reserve(countCountries * 6);
+		for (int index = 0; index < countCountries; index++)
+		{
+			Country* country = database.getCountryByIndex(index);
+			database.loadCountryDetails(*country);
+			fields.add(country->getName());
+			fields.add(country->getCapital());
+			fields.add(country->getPopulation());
+			fields.add(country->getArea());
+			fields.add(country->getLanguages());
+			fields.add(country->getGovernment());
+		}
+
+		// The first scan copies the texts in the scanner buffer.
+		MAUtil::Vector<CountryTextOccurrence> occurrences;
+		int startTime = maGetMilliSecondCount();
+		database.scanCountryText(sScannedTexts[0], occurrences);
+		printf("%s: %d countries, scanner built in %d ms\n",
+			name.c_str(), countCountries, maGetMilliSecondCount() - startTime);
+
+		int countTexts = sizeof(sScannedTexts) / sizeof(sScannedTexts[0]);
+		for (int index = 0; index < countTexts; index++)
+		{
+			MAUtil::String text = sScannedTexts[index];
+
+			startTime = maGetMilliSecondCount();
+			for (int iteration = 0; iteration < mIterations; iteration++)
+			{
+				database.scanCountryText(text, occurrences);
+			}
+			int scanTime = maGetMilliSecondCount() - startTime;
+
+			int count = 0;
+			startTime = maGetMilliSecondCount();
+			for (int iteration = 0; iteration < mIterations; iteration++)
+			{
+				count = this->countWithStrstr(fields, text.c_str());
+			}
+			int strstrTime = maGetMilliSecondCount() - startTime;
+
+			printf("  \"%s\": %d found, scan %d us, strstr %d us(%d found)\n",
+				text.c_str(),
+				occurrences.size(),
+				(int) (scanTime * 1000.0 / mIterations),
+				(int) (strstrTime * 1000.0 / mIterations),
+				count);
+		}
+	}
+
+	/**
+	 * Count the occurrences of a text with strstr().
+	 * @param fields Fields of all countries.
+	 * @param text Text to search.
+	 * @return Number of occurrences, overlapping ones included.
+	 */
+	int ScanBenchmark::countWithStrstr(
+		const MAUtil::Vector<MAUtil::String>& fields,
+		const char* text)
+	{
+		int count = 0;
+		for (int index = 0; index < fields.size(); index++)
+		{
+			const char* found = strstr(fields[index].c_str(), text);
+			while (found)
+			{
+				count++;
+				found = strstr(found + 1, text);
+			}
+		}
+		return count;
+	}
+
+} // end of EuropeanCountries
+
+#endif /* EC_BENCHMARK */
@@ -23,6 +23,17 @@
  * @brief Application controller.
  */
 
+// Number of country files read by a load job. Small jobs let idle()
+// return soon after its time is spent.
+#define LOAD_JOB_SIZE 16
+
+// Time spent reading country files by each idle() call, in milliseconds.
+#define LOAD_STEP_TIME 30
+
+// Number of countries read before the list replaces the loading screen,
+// about one screen of list items.
+#define FIRST_PAGE_SIZE 20
+
 #include <NativeUI/Screen.h>
 #include <MAUtil/Moblet.h>
 #include <conprint.h>
@@ -43,6 +54,7 @@ namespace EuropeanCountries
 	 */
 	Controller::Controller():
 		mDatabaseManager(NULL),
+		mLoadingScreen(NULL),
 		mCountriesListScreen(NULL),
 		mCountryInfoScreen(NULL),
 		mDisclaimerScreen(NULL),
@@ -51,28 +63,27 @@ namespace EuropeanCountries
 		initScreenSizeConstants();
 		initPlatformType();
 
-		LoadingScreen* loadingScreen = NULL;
-		if (isWindowsPhone())
-		{
-			// Show LoadingScreen.
-			loadingScreen = new LoadingScreen();
-			loadingScreen->show();
-		}
+		// Show LoadingScreen.
+		mLoadingScreen = new LoadingScreen();
+		this->showScreen(*mLoadingScreen);
 
-		// Create and load the database.
+		// Create the database and start loading it. Country files are read
+		// in short steps by idle(), so the application keeps handling events.
 		mDatabaseManager = new DatabaseManager();
-		mDatabaseManager->readDataFromFiles();
+		mDatabaseManager->setLoadJobSize(LOAD_JOB_SIZE);
+		mDatabaseManager->beginLoading();
 
-		// Create screens.
+		// Create screens. The countries list shows the countries read so
+		// far and is updated by the database while it loads.
 		mCountriesListScreen = new CountriesListScreen(*mDatabaseManager, *this);
 		mCountryInfoScreen = new CountryInfoScreen(*this);
 		mDisclaimerScreen = new DisclaimerScreen(*this);
 
-		// Show the country list screen.
-		this->showScreen(*mCountriesListScreen);
-
-		// Delete the loading screen.
-		delete loadingScreen;
+		if (mDatabaseManager->isLoading())
+		{
+			MAUtil::Environment::getEnvironment().addIdleListener(this);
+		}
+		this->showCountriesListIfReady();
 	}
 
 	/**
@@ -80,10 +91,15 @@ namespace EuropeanCountries
 	 */
 	Controller::~Controller()
 	{
-		delete mDatabaseManager;
+		if (mDatabaseManager->isLoading())
+		{
+			MAUtil::Environment::getEnvironment().removeIdleListener(this);
+		}
+		delete mLoadingScreen;
 		delete mCountriesListScreen;
 		delete mCountryInfoScreen;
 		delete mDisclaimerScreen;
+		delete mDatabaseManager;
 	}
 
 	/**
@@ -129,6 +145,7 @@ namespace EuropeanCountries
 		}
 
 		// Load data.
+		mDatabaseManager->loadCountryDetails(*country);
 		mCountryInfoScreen->setDisplayedCountry(*country);
 
 		// Show the screen.
@@ -165,6 +182,47 @@ namespace EuropeanCountries
 		this->showScreen(*mCountryInfoScreen);
 	}
 
+	/**
+	 * Read the next country files and show the loading progress.
+	 * Called when the application has no events to handle.
+	 * From IdleListener.
+	 */
+	void Controller::idle()
+	{
+		bool loading = mDatabaseManager->continueLoading(LOAD_STEP_TIME);
+		if (mLoadingScreen)
+		{
+			mLoadingScreen->setProgress(mDatabaseManager->countLoadedFiles(),
+				mDatabaseManager->countFilesToLoad());
+		}
+		if (!loading)
+		{
+			MAUtil::Environment::getEnvironment().removeIdleListener(this);
+		}
+		this->showCountriesListIfReady();
+	}
+
+	/**
+	 * Replace the loading screen with the countries list once the
+	 * first page of countries was read or loading is finished.
+	 */
+	void Controller::showCountriesListIfReady()
+	{
+		if (!mLoadingScreen ||
+			(mDatabaseManager->isLoading() &&
+				mDatabaseManager->countCountries() < FIRST_PAGE_SIZE))
+		{
+			return;
+		}
+
+		// Show the country list screen.
+		this->showScreen(*mCountriesListScreen);
+
+		// Delete the loading screen.
+		delete mLoadingScreen;
+		mLoadingScreen = NULL;
+	}
+
 	/**
 	 * Show a given NativeUI Screen.
 	 * @param screen Screen to show.
@@ -26,6 +26,8 @@
 #ifndef EC_CONTROLLER_H_
 #define EC_CONTROLLER_H_
 
+#include <MAUtil/Environment.h>
+
 #include "../View/CountriesListScreenObserver.h"
 #include "../View/CountryInfoScreenObserver.h"
 #include "../View/DisclaimerScreenObserver.h"
@@ -45,6 +47,7 @@ namespace EuropeanCountries
 	class CountryInfoScreen;
 	class DatabaseManager;
 	class DisclaimerScreen;
+	class LoadingScreen;
 
 	/**
 	 * @brief Application controller.
@@ -52,7 +55,8 @@ namespace EuropeanCountries
 	class Controller:
 		public CountriesListScreenObserver,
 		public CountryInfoScreenObserver,
-		public DisclaimerScreenObserver
+		public DisclaimerScreenObserver,
+		public MAUtil::IdleListener
 	{
 	public:
 		/**
@@ -102,7 +106,20 @@ namespace EuropeanCountries
 		 */
 		virtual void showCountryInfoScreen();
 
+		/**
+		 * Read the next country files and show the loading progress.
+		 * Called when the application has no events to handle.
+		 * From IdleListener.
+		 */
+		virtual void idle();
+
 	private:
+		/**
+		 * Replace the loading screen with the countries list once the
+		 * first page of countries was read or loading is finished.
+		 */
+		void showCountriesListIfReady();
+
 		/**
 		 * Show a given NativeUI Screen.
 		 * @param screen Screen to show.
@@ -115,6 +132,12 @@ namespace EuropeanCountries
 		 */
 		DatabaseManager* mDatabaseManager;
 
+		/**
+		 * Screen shown while the first countries are loading.
+		 * Deleted when the countries list is shown.
+		 */
+		LoadingScreen* mLoadingScreen;
+
 		/**
 		 * Screen used to display all countries in a list.
 		 */
@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file BundleFileReader.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Reads data files directly from the LocalFiles.bin resource.
+ */
+
+#include <MAFS/File.h>
+
+#include "BundleFileReader.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Constructor.
+	 * @param bundle Handle to the bundle resource.
+	 */
+	BundleFileReader::BundleFileReader(MAHandle bundle):
+		mBundle(bundle)
+	{
+	}
+
+	/**
+	 * Destructor.
+	 */
+	BundleFileReader::~BundleFileReader()
+	{
+	}
+
+	/**
+	 * Read the content of a given file from the bundle.
+	 * From IFileReader.
+	 * @param fileName Name of the file to read(e.g. "CountryTable").
+	 * @param outText Will contain the file content.
+	 * @return true if the file was read, false otherwise.
+	 */
+	bool BundleFileReader::readTextFromFile(
+		const MAUtil::String& fileName,
+		MAUtil::String& outText)
+	{
+		setCurrentFileSystem(mBundle, 0);
+		bool result = this->readFile(fileName, outText);
+		freeCurrentFileSystem();
+		return result;
+	}
+
+	/**
+	 * Read the content of several data files from the bundle. Each file
+	 * is passed to the listener as soon as it is read, so the reader can
+	 * use the same buffer for all files.
+	 * From IFileReader.
+	 * @param fileNames Names of the files.
+	 * @param firstIndex Index of the first file to read.
+	 * @param endIndex Index after the last file to read.
+	 * @param listener Receives the files, in array order.
+	 */
+	void BundleFileReader::readTextFromFiles(
+		const MAUtil::Vector<MAUtil::String>& fileNames,
+		const int firstIndex,
+		const int endIndex,
+		IFileBatchListener& listener)
+	{
+		// The bundle is set once for the whole batch.
+		setCurrentFileSystem(mBundle, 0);
+		MAUtil::String content;
+		for (int index = firstIndex; index < endIndex; index++)
+		{
+			if (this->readFile(fileNames[index], content))
+			{
+				listener.fileRead(index, content.c_str(), content.size());
+			}
+			else
+			{
+				listener.fileRead(index, NULL, 0);
+			}
+		}
+		freeCurrentFileSystem();
+	}
+
+	/**
+	 * Read the content of a given file from the current file system.
+	 * The bundle must be set as the current file system.
+	 * @param fileName Name of the file to read.
+	 * @param outText Will contain the file content.
+	 * @return true if the file was read, false otherwise.
+	 */
+	bool BundleFileReader::readFile(
+		const MAUtil::String& fileName,
+		MAUtil::String& outText)
+	{
+		MA_FILE* file = fopen(fileName.c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+
+		// The file is read from the resource with a single read operation.
+		fseek(file, 0, SEEK_END);
+		int size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		bool result = false;
+		if (size >= 0)
+		{
+			outText.resize(size);
+			result = (int) fread(outText.pointer(), 1, size, file) == size;
+		}
+		fclose(file);
+		return result;
+	}
+
+} // end of EuropeanCountries
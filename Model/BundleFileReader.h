@@ -0,0 +1,108 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file BundleFileReader.h
+ * @author Bogdan Iusco
+ *
+ * @brief Reads data files directly from the LocalFiles.bin resource.
+ */
+
+#ifndef EC_BUNDLE_FILE_READER_H_
+#define EC_BUNDLE_FILE_READER_H_
+
+#include <maapi.h>
+#include <MAUtil/String.h>
+
+#include "IFileReader.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Reads files stored in a file system bundle resource(such as
+	 * LocalFiles.bin) without extracting them to the local file system.
+	 * The bundle is set as the current MAFS file system only while a read
+	 * call runs, so other MAFS users and other readers are not affected
+	 * between calls.
+	 */
+	class BundleFileReader:
+		public IFileReader
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param bundle Handle to the bundle resource.
+		 */
+		BundleFileReader(MAHandle bundle);
+
+		/**
+		 * Destructor.
+		 */
+		virtual ~BundleFileReader();
+
+		/**
+		 * Read the content of a given file from the bundle.
+		 * From IFileReader.
+		 * @param fileName Name of the file to read(e.g. "CountryTable").
+		 * @param outText Will contain the file content.
+		 * @return true if the file was read, false otherwise.
+		 */
+		virtual bool readTextFromFile(
+			const MAUtil::String& fileName,
+			MAUtil::String& outText);
+
+		/**
+		 * Read the content of several data files. Each file is passed to
+		 * the listener as soon as it is read, so the reader can use the
+		 * same buffer for all files.
+		 * From IFileReader.
+		 * @param fileNames Names of the files.
+		 * @param firstIndex Index of the first file to read.
+		 * @param endIndex Index after the last file to read.
+		 * @param listener Receives the files, in array order.
+		 */
+		virtual void readTextFromFiles(
+			const MAUtil::Vector<MAUtil::String>& fileNames,
+			const int firstIndex,
+			const int endIndex,
+			IFileBatchListener& listener);
+
+	private:
+		/**
+		 * Read the content of a given file from the current file system.
+		 * The bundle must be set as the current file system.
+		 * @param fileName Name of the file to read.
+		 * @param outText Will contain the file content.
+		 * @return true if the file was read, false otherwise.
+		 */
+		bool readFile(
+			const MAUtil::String& fileName,
+			MAUtil::String& outText);
+
+	private:
+		/**
+		 * Handle to the bundle resource.
+		 */
+		MAHandle mBundle;
+
+	}; // end of BundleFileReader
+
+} // end of EuropeanCountries
+
+#endif /* EC_BUNDLE_FILE_READER_H_ */
@@ -30,11 +30,20 @@ namespace EuropeanCountries
 
 	/**
 	 * Constructor.
-	 * Automatically creates an id for the returned object.
+	 * @param id Country's id. The database uses the position of the
+	 * country in the CountryTable file, so ids are in the range
+	 * 0..N-1 and do not change between launches.
 	 */
-	Country::Country()
+	Country::Country(const int id):
+		mID(id),
+		mFlagImage(0),
+		mFileName(StringArena::emptySlice()),
+		mName(StringArena::emptySlice()),
+		mPopulation(StringArena::emptySlice()),
+		mArea(StringArena::emptySlice()),
+		mCapital(StringArena::emptySlice()),
+		mHasDetails(false)
 	{
-		mID = maCreatePlaceholder();
 	}
 
 	/**
@@ -42,12 +51,10 @@ namespace EuropeanCountries
 	 */
 	Country::~Country()
 	{
-		maDestroyPlaceholder(mID);
 	}
 
 	/**
 	 * Get country's id.
-	 * The id is automatically created and it cannot be changed.
 	 * @return Country's ID.
 	 */
 	int Country::getID() const
@@ -55,6 +62,46 @@ namespace EuropeanCountries
 		return mID;
 	}
 
+	/**
+	 * Set country's id.
+	 * Only the database should call it, while the country is not yet
+	 * listed in it.
+	 * @param id Position of the country in the database.
+	 */
+	void Country::setID(const int id)
+	{
+		mID = id;
+	}
+
+	/**
+	 * Set the name of the file that contains the country data.
+	 * @param fileName File name, as listed in the CountryTable file.
+	 * The text is not copied: it must be valid while the country exists.
+	 */
+	void Country::setFileName(const StringSlice& fileName)
+	{
+		mFileName = fileName;
+	}
+
+	/**
+	 * Get the name of the file that contains the country data.
+	 * @return File name, as listed in the CountryTable file.
+	 */
+	MAUtil::String Country::getFileName() const
+	{
+		return MAUtil::String(mFileName.text, mFileName.length);
+	}
+
+	/**
+	 * Get the name of the country data file without copying it.
+	 * Valid while the country exists.
+	 * @return Null terminated text and its length.
+	 */
+	StringSlice Country::getFileNameSlice() const
+	{
+		return mFileName;
+	}
+
 	/**
 	 * Set country flag id.
 	 * @param flagID Image handle to a resource file.
@@ -76,8 +123,9 @@ namespace EuropeanCountries
 	/**
 	 * Set country name.
 	 * @param name Name to set.
+	 * The text is not copied: it must be valid while the country exists.
 	 */
-	void Country::setName(const MAUtil::String& name)
+	void Country::setName(const StringSlice& name)
 	{
 		mName = name;
 	}
@@ -87,6 +135,16 @@ namespace EuropeanCountries
 	 * @return Country name.
 	 */
 	MAUtil::String Country::getName() const
+	{
+		return MAUtil::String(mName.text, mName.length);
+	}
+
+	/**
+	 * Get country name without copying it.
+	 * Valid while the country exists.
+	 * @return Null terminated text and its length.
+	 */
+	StringSlice Country::getNameSlice() const
 	{
 		return mName;
 	}
@@ -94,8 +152,9 @@ namespace EuropeanCountries
 	/**
 	 * Set country population.
 	 * @param population Text to set.
+	 * The text is not copied: it must be valid while the country exists.
 	 */
-	void Country::setPopulation(const MAUtil::String& population)
+	void Country::setPopulation(const StringSlice& population)
 	{
 		mPopulation = population;
 	}
@@ -105,6 +164,16 @@ namespace EuropeanCountries
 	 * @return Country name.
 	 */
 	MAUtil::String Country::getPopulation() const
+	{
+		return MAUtil::String(mPopulation.text, mPopulation.length);
+	}
+
+	/**
+	 * Get country population without copying it.
+	 * Valid while the country exists.
+	 * @return Null terminated text and its length.
+	 */
+	StringSlice Country::getPopulationSlice() const
 	{
 		return mPopulation;
 	}
@@ -112,8 +181,9 @@ namespace EuropeanCountries
 	/**
 	 * Set country area.
 	 * @param area Text to set.
+	 * The text is not copied: it must be valid while the country exists.
 	 */
-	void Country::setArea(const MAUtil::String& area)
+	void Country::setArea(const StringSlice& area)
 	{
 		mArea = area;
 	}
@@ -123,6 +193,16 @@ namespace EuropeanCountries
 	 * @return Country area.
 	 */
 	MAUtil::String Country::getArea() const
+	{
+		return MAUtil::String(mArea.text, mArea.length);
+	}
+
+	/**
+	 * Get country area without copying it.
+	 * Valid while the country exists.
+	 * @return Null terminated text and its length.
+	 */
+	StringSlice Country::getAreaSlice() const
 	{
 		return mArea;
 	}
@@ -145,6 +225,19 @@ namespace EuropeanCountries
 		return mLanguages;
 	}
 
+	/**
+	 * Get country languages without copying it.
+	 * Valid until the details are released(see clearDetails()).
+	 * @return Null terminated text and its length.
+	 */
+	StringSlice Country::getLanguagesSlice() const
+	{
+		StringSlice slice;
+		slice.text = mLanguages.c_str();
+		slice.length = mLanguages.length();
+		return slice;
+	}
+
 	/**
 	 * Set country government.
 	 * @param government Text to set.
@@ -163,11 +256,25 @@ namespace EuropeanCountries
 		return mGovernment;
 	}
 
+	/**
+	 * Get country government without copying it.
+	 * Valid until the details are released(see clearDetails()).
+	 * @return Null terminated text and its length.
+	 */
+	StringSlice Country::getGovernmentSlice() const
+	{
+		StringSlice slice;
+		slice.text = mGovernment.c_str();
+		slice.length = mGovernment.length();
+		return slice;
+	}
+
 	/**
 	 * Set country capital.
 	 * @param capital Text to set.
+	 * The text is not copied: it must be valid while the country exists.
 	 */
-	void Country::setCapital(const MAUtil::String& capital)
+	void Country::setCapital(const StringSlice& capital)
 	{
 		mCapital = capital;
 	}
@@ -177,8 +284,62 @@ namespace EuropeanCountries
 	 * @return Country capital.
 	 */
 	MAUtil::String Country::getCapital() const
+	{
+		return MAUtil::String(mCapital.text, mCapital.length);
+	}
+
+	/**
+	 * Get country capital without copying it.
+	 * Valid while the country exists.
+	 * @return Null terminated text and its length.
+	 */
+	StringSlice Country::getCapitalSlice() const
 	{
 		return mCapital;
 	}
 
+	/**
+	 * Check if the detail fields(languages and government) are loaded.
+	 * @return true if the detail fields are loaded, false otherwise.
+	 */
+	bool Country::hasDetails() const
+	{
+		return mHasDetails;
+	}
+
+	/**
+	 * Mark the detail fields as loaded or not loaded.
+	 * @param hasDetails true if the detail fields are loaded.
+	 */
+	void Country::setHasDetails(const bool hasDetails)
+	{
+		mHasDetails = hasDetails;
+	}
+
+	/**
+	 * Release the detail fields(languages and government).
+	 * They can be loaded again from the country file.
+	 */
+	void Country::clearDetails()
+	{
+		mLanguages = MAUtil::String();
+		mGovernment = MAUtil::String();
+		mHasDetails = false;
+	}
+
+	/**
+	 * Copy the texts of the summary fields into a given arena and
+	 * point the fields to the copies. Used before the arena that
+	 * holds the texts is released.
+	 * @param stringArena Arena that will hold the texts.
+	 */
+	void Country::copySummaryTexts(StringArena& stringArena)
+	{
+		mFileName = stringArena.add(mFileName.text, mFileName.length);
+		mName = stringArena.add(mName.text, mName.length);
+		mPopulation = stringArena.add(mPopulation.text, mPopulation.length);
+		mArea = stringArena.add(mArea.text, mArea.length);
+		mCapital = stringArena.add(mCapital.text, mCapital.length);
+	}
+
 } // end of EuropeanCountries
@@ -28,17 +28,49 @@
 
 #include <MAUtil/String.h>
 
+#include "StringArena.h"
+
 namespace EuropeanCountries
 {
 
+	/**
+	 * Groups of country fields that can be loaded separately.
+	 */
+	enum CountryFields
+	{
+		/**
+		 * Fields needed by the countries list: file name, flag, name,
+		 * population, area and capital.
+		 */
+		CountrySummaryFields = 1,
+
+		/**
+		 * Long text fields shown only by the country info screen:
+		 * languages and government.
+		 */
+		CountryDetailFields = 2,
+
+		/**
+		 * All fields.
+		 */
+		CountryAllFields = CountrySummaryFields | CountryDetailFields
+	};
+
+	/**
+	 * @brief Stores information about a country.
+	 * Summary fields point to texts owned by the database(usually stored
+	 * in its string arena), detail fields are owned by the country.
+	 */
 	class Country
 	{
 	public:
 		/**
 		 * Constructor.
-		 * Automatically creates an id for the returned object.
+		 * @param id Country's id. The database uses the position of the
+		 * country in the CountryTable file, so ids are in the range
+		 * 0..N-1 and do not change between launches.
 		 */
-		Country();
+		Country(const int id);
 
 		/**
 		 * Destructor.
@@ -47,11 +79,38 @@ namespace EuropeanCountries
 
 		/**
 		 * Get country's id.
-		 * The id is automatically created and it cannot be changed.
 		 * @return Country's ID.
 		 */
 		int getID() const;
 
+		/**
+		 * Set country's id.
+		 * Only the database should call it, while the country is not yet
+		 * listed in it.
+		 * @param id Position of the country in the database.
+		 */
+		void setID(const int id);
+
+		/**
+		 * Set the name of the file that contains the country data.
+		 * @param fileName File name, as listed in the CountryTable file.
+		 * The text is not copied: it must be valid while the country exists.
+		 */
+		void setFileName(const StringSlice& fileName);
+
+		/**
+		 * Get the name of the file that contains the country data.
+		 * @return File name, as listed in the CountryTable file.
+		 */
+		MAUtil::String getFileName() const;
+
+		/**
+		 * Get the name of the country data file without copying it.
+		 * Valid while the country exists.
+		 * @return Null terminated text and its length.
+		 */
+		StringSlice getFileNameSlice() const;
+
 		/**
 		 * Set country flag id.
 		 * @param flagID Image handle to a resource file.
@@ -67,8 +126,9 @@ namespace EuropeanCountries
 		/**
 		 * Set country name.
 		 * @param name Name to set.
+		 * The text is not copied: it must be valid while the country exists.
 		 */
-		void setName(const MAUtil::String& name);
+		void setName(const StringSlice& name);
 
 		/**
 		 * Get country name.
@@ -76,11 +136,19 @@ namespace EuropeanCountries
 		 */
 		MAUtil::String getName() const;
 
+		/**
+		 * Get country name without copying it.
+		 * Valid while the country exists.
+		 * @return Null terminated text and its length.
+		 */
+		StringSlice getNameSlice() const;
+
 		/**
 		 * Set country population.
 		 * @param population Text to set.
+		 * The text is not copied: it must be valid while the country exists.
 		 */
-		void setPopulation(const MAUtil::String& population);
+		void setPopulation(const StringSlice& population);
 
 		/**
 		 * Get country population.
@@ -88,11 +156,19 @@ namespace EuropeanCountries
 		 */
 		MAUtil::String getPopulation() const;
 
+		/**
+		 * Get country population without copying it.
+		 * Valid while the country exists.
+		 * @return Null terminated text and its length.
+		 */
+		StringSlice getPopulationSlice() const;
+
 		/**
 		 * Set country area.
 		 * @param area Text to set.
+		 * The text is not copied: it must be valid while the country exists.
 		 */
-		void setArea(const MAUtil::String& area);
+		void setArea(const StringSlice& area);
 
 		/**
 		 * Get country area.
@@ -100,6 +176,13 @@ namespace EuropeanCountries
 		 */
 		MAUtil::String getArea() const;
 
+		/**
+		 * Get country area without copying it.
+		 * Valid while the country exists.
+		 * @return Null terminated text and its length.
+		 */
+		StringSlice getAreaSlice() const;
+
 		/**
 		 * Set country languages.
 		 * @param languages Text to set.
@@ -112,6 +195,13 @@ namespace EuropeanCountries
 		 */
 		MAUtil::String getLanguages() const;
 
+		/**
+		 * Get country languages without copying it.
+		 * Valid until the details are released(see clearDetails()).
+		 * @return Null terminated text and its length.
+		 */
+		StringSlice getLanguagesSlice() const;
+
 		/**
 		 * Set country government.
 		 * @param government Text to set.
@@ -124,11 +214,19 @@ namespace EuropeanCountries
 		 */
 		MAUtil::String getGovernment() const;
 
+		/**
+		 * Get country government without copying it.
+		 * Valid until the details are released(see clearDetails()).
+		 * @return Null terminated text and its length.
+		 */
+		StringSlice getGovernmentSlice() const;
+
 		/**
 		 * Set country capital.
 		 * @param capital Text to set.
+		 * The text is not copied: it must be valid while the country exists.
 		 */
-		void setCapital(const MAUtil::String& capital);
+		void setCapital(const StringSlice& capital);
 
 		/**
 		 * Get country capital.
@@ -136,6 +234,39 @@ namespace EuropeanCountries
 		 */
 		MAUtil::String getCapital() const;
 
+		/**
+		 * Get country capital without copying it.
+		 * Valid while the country exists.
+		 * @return Null terminated text and its length.
+		 */
+		StringSlice getCapitalSlice() const;
+
+		/**
+		 * Check if the detail fields(languages and government) are loaded.
+		 * @return true if the detail fields are loaded, false otherwise.
+		 */
+		bool hasDetails() const;
+
+		/**
+		 * Mark the detail fields as loaded or not loaded.
+		 * @param hasDetails true if the detail fields are loaded.
+		 */
+		void setHasDetails(const bool hasDetails);
+
+		/**
+		 * Release the detail fields(languages and government).
+		 * They can be loaded again from the country file.
+		 */
+		void clearDetails();
+
+		/**
+		 * Copy the texts of the summary fields into a given arena and
+		 * point the fields to the copies. Used before the arena that
+		 * holds the texts is released.
+		 * @param stringArena Arena that will hold the texts.
+		 */
+		void copySummaryTexts(StringArena& stringArena);
+
 	private:
 
 		/**
@@ -149,20 +280,25 @@ namespace EuropeanCountries
 		 */
 		int mFlagImage;
 
+		/**
+		 * Name of the file that contains the country data.
+		 */
+		StringSlice mFileName;
+
 		/**
 		 * Country name.
 		 */
-		MAUtil::String mName;
+		StringSlice mName;
 
 		/**
 		 * Country population.
 		 */
-		MAUtil::String mPopulation;
+		StringSlice mPopulation;
 
 		/**
 		 * Country area.
 		 */
-		MAUtil::String mArea;
+		StringSlice mArea;
 
 		/**
 		 * Country languages.
@@ -177,7 +313,12 @@ namespace EuropeanCountries
 		/**
 		 * Country capital.
 		 */
-		MAUtil::String mCapital;
+		StringSlice mCapital;
+
+		/**
+		 * True if mLanguages and mGovernment are loaded.
+		 */
+		bool mHasDetails;
 
 	}; // end of Country
 
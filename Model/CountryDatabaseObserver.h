@@ -0,0 +1,63 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryDatabaseObserver.h
+ * @author Bogdan Iusco
+ *
+ * @brief Observer for ICountryDatabase.
+ */
+
+#ifndef EC_COUNTRY_DATABASE_OBSERVER_H_
+#define EC_COUNTRY_DATABASE_OBSERVER_H_
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Observer for ICountryDatabase.
+	 * Lets a view show the countries while the database is still loading.
+	 */
+	class CountryDatabaseObserver
+	{
+	public:
+		/**
+		 * Called after countries were added at the end of the database.
+		 * @param firstID Id of the first added country.
+		 * @param countCountries Number of added countries. Their ids are
+		 * consecutive.
+		 */
+		virtual void countriesAdded(
+			const int firstID,
+			const int countCountries) = 0;
+
+		/**
+		 * Called after all countries were removed from the database.
+		 */
+		virtual void countriesRemoved() = 0;
+
+		/**
+		 * Called after the last country was added, when the database is
+		 * fully loaded.
+		 */
+		virtual void loadingFinished() = 0;
+	};
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_DATABASE_OBSERVER_H_ */
@@ -0,0 +1,573 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryFuzzyIndex.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Typo tolerant search over country and capital names.
+ */
+
+// Longer searched texts are truncated. A text must fit in the bits of
+// an unsigned int(see computeDistance()).
+#define MAX_FUZZY_TEXT_LENGTH 32
+
+#include <mastdlib.h>
+
+#include "CountryFuzzyIndex.h"
+#include "CountrySearchIndex.h"
+#include "CountrySummaryTable.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Create the key of a trigram.
+	 * @param a First character, lower case.
+	 * @param b Second character, lower case.
+	 * @param c Third character, lower case.
+	 * @return Trigram key.
+	 */
+	static inline int makeTrigram(
+		const unsigned char a,
+		const unsigned char b,
+		const unsigned char c)
+	{
+		return (a << 16) | (b << 8) | c;
+	}
+
+	/**
+	 * Get the set of ASCII letters of a text.
+	 * @param text Null terminated text.
+	 * @return A value that has bit i set if the text contains letter
+	 * 'a' + i, in any case.
+	 */
+	static unsigned int getLetterSet(const char* text)
+	{
+		unsigned int letters = 0;
+		for (; *text; text++)
+		{
+			unsigned char c = toLowerASCII(*text);
+			if (c >= 'a' && c <= 'z')
+			{
+				letters |= 1u << (c - 'a');
+			}
+		}
+		return letters;
+	}
+
+	/**
+	 * Count the bits set in a value.
+	 * @param value Value to check.
+	 * @return Number of bits set.
+	 */
+	static inline int countBits(unsigned int value)
+	{
+		int count = 0;
+		for (; value != 0; value &= value - 1)
+		{
+			count++;
+		}
+		return count;
+	}
+
+	/**
+	 * Get the maximum number of mistakes allowed for a text.
+	 * @param length Text length.
+	 * @return Maximum edit distance.
+	 */
+	static inline int getMaxDistance(const int length)
+	{
+		if (length <= 7)
+		{
+			return 1;
+		}
+		return length <= 11 ? 2 : 3;
+	}
+
+	/**
+	 * Compares two trigram pairs by trigram for mergeSort().
+	 * The sort is stable, so the entries of a trigram stay ascending.
+	 */
+	struct TrigramPairCompare
+	{
+		int operator()(
+			const CountryFuzzyIndex::TrigramPair& first,
+			const CountryFuzzyIndex::TrigramPair& second) const
+		{
+			return first.trigram - second.trigram;
+		}
+	};
+
+	/**
+	 * Compares two candidates for mergeSort(). Smaller distances go first,
+	 * then the candidates that share more trigrams with the searched text.
+	 */
+	struct CandidateCompare
+	{
+		int operator()(
+			const CountryFuzzyIndex::Candidate& first,
+			const CountryFuzzyIndex::Candidate& second) const
+		{
+			if (first.distance != second.distance)
+			{
+				return first.distance - second.distance;
+			}
+			return second.sharedTrigrams - first.sharedTrigrams;
+		}
+	};
+
+	/**
+	 * Constructor.
+	 * @param summaryTable Table that contains the names and capitals.
+	 */
+	CountryFuzzyIndex::CountryFuzzyIndex(
+		const CountrySummaryTable& summaryTable):
+		mSummaryTable(summaryTable),
+		mCountIndexedRows(-1),
+		mStamp(0)
+	{
+	}
+
+	/**
+	 * Find the countries that match a given text.
+	 * The number of allowed mistakes depends on the text length:
+	 * one for up to 7 characters, two for up to 11 and three for
+	 * longer texts.
+	 * @param text Text typed by the user.
+	 * @param maxResults Maximum number of returned countries.
+	 * @param outMatches Will contain the found countries, the best
+	 * match first. A country appears only once.
+	 */
+	void CountryFuzzyIndex::search(
+		const MAUtil::String& text,
+		const int maxResults,
+		MAUtil::Vector<CountryFuzzyMatch>& outMatches)
+	{
+		outMatches.clear();
+
+		// Rows may have been added since the index was built.
+		if (mCountIndexedRows != mSummaryTable.countRows())
+		{
+			this->build();
+		}
+
+		// Use the lower case text, without spaces at the ends.
+		int start = 0;
+		int end = text.length();
+		while (start < end && text[start] == ' ')
+		{
+			start++;
+		}
+		while (end > start && text[end - 1] == ' ')
+		{
+			end--;
+		}
+		char pattern[MAX_FUZZY_TEXT_LENGTH + 1];
+		int length = 0;
+		for (int index = start; index < end && length < MAX_FUZZY_TEXT_LENGTH;
+			index++)
+		{
+			pattern[length++] = toLowerASCII(text[index]);
+		}
+		if (length == 0)
+		{
+			return;
+		}
+
+		pattern[length] = '\0';
+		unsigned int patternLetters = getLetterSet(pattern);
+
+		// Bit i of the mask of a character is set if pattern[i] is that
+		// character.
+		memset(mPatternMasks, 0, sizeof(mPatternMasks));
+		for (int index = 0; index < length; index++)
+		{
+			mPatternMasks[(unsigned char) pattern[index]] |= 1u << index;
+		}
+
+		// Count the trigrams shared by each entry with the text. The text
+		// is padded with spaces, like the indexed names.
+		mStamp++;
+		int countTrigrams = 0;
+		MAUtil::Vector<int> queryTrigrams;
+		MAUtil::Vector<int> touchedEntries;
+		for (int index = -1; index + 2 <= length; index++)
+		{
+			int trigram = makeTrigram(
+				index < 0 ? ' ' : pattern[index],
+				pattern[index + 1],
+				index + 2 < length ? pattern[index + 2] : ' ');
+			bool isNew = true;
+			for (int previous = 0; previous < queryTrigrams.size(); previous++)
+			{
+				isNew = isNew && queryTrigrams[previous] != trigram;
+			}
+			if (!isNew)
+			{
+				continue;
+			}
+			queryTrigrams.add(trigram);
+			countTrigrams++;
+
+			int found = this->findTrigram(trigram);
+			if (found < 0)
+			{
+				continue;
+			}
+			for (int posting = mTrigramStarts[found];
+				posting < mTrigramStarts[found + 1]; posting++)
+			{
+				int entry = mTrigramEntries[posting];
+				if (mEntryStamps[entry] != mStamp)
+				{
+					mEntryStamps[entry] = mStamp;
+					mSharedCounts[entry] = 0;
+					touchedEntries.add(entry);
+				}
+				mSharedCounts[entry]++;
+			}
+		}
+
+		// Each mistake changes at most 3 trigrams, and the 2 padded trigrams
+		// are lost if the text is found inside a word. So an entry at
+		// distance d shares at least countTrigrams - 2 - 3 * d trigrams.
+		// Entries that share no trigram are not compared with the text.
+		// This can miss some matches of short texts, where a few mistakes
+		// change all trigrams, but keeps the search from reading all entries.
+		int maxDistance = getMaxDistance(length);
+		int minShared = countTrigrams - 3 * maxDistance - 2;
+		if (minShared < 1)
+		{
+			minShared = 1;
+		}
+
+		// Group the entries by shared trigrams, most shared first.
+		MAUtil::Vector<int> groupStarts;
+		groupStarts.resize(countTrigrams + 2);
+		for (int shared = 0; shared < countTrigrams + 2; shared++)
+		{
+			groupStarts[shared] = 0;
+		}
+		for (int index = 0; index < touchedEntries.size(); index++)
+		{
+			groupStarts[countTrigrams - mSharedCounts[touchedEntries[index]] + 1]++;
+		}
+		for (int group = 1; group < countTrigrams + 2; group++)
+		{
+			groupStarts[group] += groupStarts[group - 1];
+		}
+		MAUtil::Vector<int> groupedEntries;
+		groupedEntries.resize(touchedEntries.size());
+		for (int index = 0; index < touchedEntries.size(); index++)
+		{
+			int entry = touchedEntries[index];
+			groupedEntries[groupStarts[countTrigrams - mSharedCounts[entry]]++] =
+				entry;
+		}
+
+		// Compare the entries with the text, most shared trigrams first.
+		// Element d of countFound is the number of countries whose best
+		// entry found so far is at distance d. Verification stops when
+		// enough countries are found at distances that the remaining
+		// entries cannot beat.
+		MAUtil::Vector<Candidate> candidates;
+		MAUtil::Vector<int> countFound;
+		countFound.resize(maxDistance + 1);
+		for (int distance = 0; distance <= maxDistance; distance++)
+		{
+			countFound[distance] = 0;
+		}
+		int index = 0;
+		int countBetter = 0;
+		for (int shared = countTrigrams; shared >= minShared; shared--)
+		{
+			int minDistance = (countTrigrams - 2 - shared + 2) / 3;
+			if (minDistance > maxDistance)
+			{
+				break;
+			}
+
+			for (; index < groupedEntries.size() &&
+				mSharedCounts[groupedEntries[index]] == shared; index++)
+			{
+				// Entries that are not verified yet are ranked after the
+				// found ones with the same distance.
+				countBetter = 0;
+				for (int distance = 0; distance <= minDistance; distance++)
+				{
+					countBetter += countFound[distance];
+				}
+				if (countBetter >= maxResults)
+				{
+					break;
+				}
+
+				// Each letter of the text that is missing from the entry
+				// needs at least one mistake.
+				int entry = groupedEntries[index];
+				if (countBits(patternLetters & ~mEntryLetters[entry]) >
+					maxDistance)
+				{
+					continue;
+				}
+
+				int countryID = entry / 2;
+				const char* entryText = (entry % 2 == 0) ?
+					mSummaryTable.getName(countryID).text :
+					mSummaryTable.getCapital(countryID).text;
+				int distance = this->computeDistance(length, entryText);
+				if (distance > maxDistance)
+				{
+					continue;
+				}
+
+				Candidate candidate;
+				candidate.entry = entry;
+				candidate.distance = distance;
+				candidate.sharedTrigrams = shared;
+				candidates.add(candidate);
+
+				if (mCountryStamps[countryID] != mStamp)
+				{
+					mCountryStamps[countryID] = mStamp;
+					mCountryDistances[countryID] = distance;
+					countFound[distance]++;
+				}
+				else if (distance < mCountryDistances[countryID])
+				{
+					countFound[mCountryDistances[countryID]]--;
+					mCountryDistances[countryID] = distance;
+					countFound[distance]++;
+				}
+			}
+			if (countBetter >= maxResults)
+			{
+				break;
+			}
+		}
+		if (candidates.size() > 0)
+		{
+			CandidateCompare compare;
+			mergeSort(&candidates[0], candidates.size(), compare);
+		}
+
+		// Keep the best entry of each country. A returned country is marked
+		// by setting its distance to -1.
+		for (index = 0;
+			index < candidates.size() && outMatches.size() < maxResults;
+			index++)
+		{
+			int countryID = candidates[index].entry / 2;
+			if (mCountryDistances[countryID] < 0)
+			{
+				continue;
+			}
+			mCountryDistances[countryID] = -1;
+
+			CountryFuzzyMatch match;
+			match.countryID = countryID;
+			match.field = (candidates[index].entry % 2 == 0) ?
+				CountrySearchName : CountrySearchCapital;
+			match.distance = candidates[index].distance;
+			outMatches.add(match);
+		}
+	}
+
+	/**
+	 * Remove the index. Must be called when the data changes.
+	 */
+	void CountryFuzzyIndex::invalidate()
+	{
+		mTrigrams.clear();
+		mTrigramStarts.clear();
+		mTrigramEntries.clear();
+		mEntryLetters.clear();
+		mSharedCounts.clear();
+		mEntryStamps.clear();
+		mCountryDistances.clear();
+		mCountryStamps.clear();
+		mCountIndexedRows = -1;
+	}
+
+	/**
+	 * Create the trigram lists.
+	 */
+	void CountryFuzzyIndex::build()
+	{
+		this->invalidate();
+
+		MAUtil::Vector<TrigramPair> pairs;
+		int countRows = mSummaryTable.countRows();
+		for (int countryID = 0; countryID < countRows; countryID++)
+		{
+			const char* name = mSummaryTable.getName(countryID).text;
+			const char* capital = mSummaryTable.getCapital(countryID).text;
+			this->addTrigrams(name, 2 * countryID, pairs);
+			this->addTrigrams(capital, 2 * countryID + 1, pairs);
+			mEntryLetters.add(getLetterSet(name));
+			mEntryLetters.add(getLetterSet(capital));
+			mSharedCounts.add(0);
+			mSharedCounts.add(0);
+			mEntryStamps.add(0);
+			mEntryStamps.add(0);
+			mCountryDistances.add(0);
+			mCountryStamps.add(0);
+		}
+		if (pairs.size() > 0)
+		{
+			TrigramPairCompare compare;
+			mergeSort(&pairs[0], pairs.size(), compare);
+		}
+
+		// Group the entries by trigram. An entry that contains a trigram
+		// several times is added once.
+		for (int index = 0; index < pairs.size(); index++)
+		{
+			const TrigramPair& pair = pairs[index];
+			if (index == 0 || pair.trigram != pairs[index - 1].trigram)
+			{
+				mTrigrams.add(pair.trigram);
+				mTrigramStarts.add(mTrigramEntries.size());
+			}
+			else if (pair.entry == pairs[index - 1].entry)
+			{
+				continue;
+			}
+			mTrigramEntries.add(pair.entry);
+		}
+		mTrigramStarts.add(mTrigramEntries.size());
+
+		mCountIndexedRows = countRows;
+		mStamp = 0;
+	}
+
+	/**
+	 * Add the trigrams of a text to a given array.
+	 * @param text Null terminated text.
+	 * @param entry Index of the entry.
+	 * @param pairs The trigrams are added to this array.
+	 */
+	void CountryFuzzyIndex::addTrigrams(
+		const char* text,
+		const int entry,
+		MAUtil::Vector<TrigramPair>& pairs)
+	{
+		if (text[0] == '\0')
+		{
+			return;
+		}
+
+		// The text is padded with a space at each end, so the first and
+		// last characters are part of two trigrams.
+		unsigned char a = ' ';
+		unsigned char b = toLowerASCII(text[0]);
+		for (int index = 1; ; index++)
+		{
+			unsigned char c = text[index] ? toLowerASCII(text[index]) : ' ';
+			TrigramPair pair;
+			pair.trigram = makeTrigram(a, b, c);
+			pair.entry = entry;
+			pairs.add(pair);
+			if (text[index] == '\0')
+			{
+				break;
+			}
+			a = b;
+			b = c;
+		}
+	}
+
+	/**
+	 * Find a trigram.
+	 * @param trigram Trigram key.
+	 * @return Index in mTrigrams, or -1 if no entry contains it.
+	 */
+	int CountryFuzzyIndex::findTrigram(const int trigram) const
+	{
+		int low = 0;
+		int high = mTrigrams.size();
+		while (low < high)
+		{
+			int middle = (low + high) / 2;
+			if (mTrigrams[middle] < trigram)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		return (low < mTrigrams.size() && mTrigrams[low] == trigram) ? low : -1;
+	}
+
+	/**
+	 * Compute the smallest edit distance between the searched text and
+	 * any part of a given text. Uses the bit-parallel algorithm of Myers:
+	 * a column of the edit distance table is kept as the bit vectors of
+	 * its vertical differences, so each text character costs a few word
+	 * operations.
+	 * @param patternLength Length of the searched text. The masks of its
+	 * characters must be set in mPatternMasks.
+	 * @param text Null terminated text.
+	 * @return The distance.
+	 */
+	int CountryFuzzyIndex::computeDistance(
+		const int patternLength,
+		const char* text) const
+	{
+		unsigned int positive = ~0u;
+		unsigned int negative = 0;
+		unsigned int lastBit = 1u << (patternLength - 1);
+		int score = patternLength;
+		int best = patternLength;
+		for (int position = 0; text[position] && best > 0; position++)
+		{
+			unsigned int equal = mPatternMasks[toLowerASCII(text[position])];
+			unsigned int verticalMask = equal | negative;
+			unsigned int horizontalMask =
+				(((equal & positive) + positive) ^ positive) | equal;
+			unsigned int horizontalPositive =
+				negative | ~(horizontalMask | positive);
+			unsigned int horizontalNegative = positive & horizontalMask;
+			if (horizontalPositive & lastBit)
+			{
+				score++;
+			}
+			else if (horizontalNegative & lastBit)
+			{
+				score--;
+			}
+
+			// A match can start anywhere, so the first row stays zero.
+			horizontalPositive <<= 1;
+			horizontalNegative <<= 1;
+			positive = horizontalNegative |
+				~(verticalMask | horizontalPositive);
+			negative = horizontalPositive & verticalMask;
+			if (score < best)
+			{
+				best = score;
+			}
+		}
+		return best;
+	}
+
+} // end of EuropeanCountries
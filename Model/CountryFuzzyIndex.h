@@ -0,0 +1,252 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryFuzzyIndex.h
+ * @author Bogdan Iusco
+ *
+ * @brief Typo tolerant search over country and capital names.
+ */
+
+#ifndef EC_COUNTRY_FUZZY_INDEX_H_
+#define EC_COUNTRY_FUZZY_INDEX_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	// Forward declarations for EuropeanCountries namespace classes.
+	class CountrySummaryTable;
+
+	/**
+	 * @brief A country found by a fuzzy search.
+	 */
+	struct CountryFuzzyMatch
+	{
+		/**
+		 * Id of the country.
+		 */
+		int countryID;
+
+		/**
+		 * Field that matched(CountrySearchField value).
+		 */
+		int field;
+
+		/**
+		 * Number of inserted, deleted or replaced characters needed to find
+		 * the searched text in the field.
+		 */
+		int distance;
+	};
+
+	/**
+	 * @brief Finds the countries whose name or capital contains a text
+	 * with a few typing mistakes, e.g. "Chech Republic" or "Macedona".
+	 * Each name and capital is split in trigrams(groups of 3 consecutive
+	 * characters). A text with few mistakes keeps most of its trigrams, so
+	 * only the names that share enough trigrams with the searched text are
+	 * compared with it. A name that shares no trigram with a short text is
+	 * not found, even if it is close to it. Case is ignored for ASCII
+	 * letters.
+	 */
+	class CountryFuzzyIndex
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param summaryTable Table that contains the names and capitals.
+		 */
+		CountryFuzzyIndex(const CountrySummaryTable& summaryTable);
+
+		/**
+		 * Find the countries that match a given text.
+		 * The number of allowed mistakes depends on the text length:
+		 * one for up to 7 characters, two for up to 11 and three for
+		 * longer texts.
+		 * @param text Text typed by the user.
+		 * @param maxResults Maximum number of returned countries.
+		 * @param outMatches Will contain the found countries, the best
+		 * match first. A country appears only once.
+		 */
+		void search(
+			const MAUtil::String& text,
+			const int maxResults,
+			MAUtil::Vector<CountryFuzzyMatch>& outMatches);
+
+		/**
+		 * Remove the index. Must be called when the data changes.
+		 */
+		void invalidate();
+
+	private:
+		/**
+		 * A candidate that passed the trigram filter.
+		 */
+		struct Candidate
+		{
+			/**
+			 * Index of the entry.
+			 */
+			int entry;
+
+			/**
+			 * Edit distance to the searched text.
+			 */
+			int distance;
+
+			/**
+			 * Number of trigrams shared with the searched text.
+			 */
+			int sharedTrigrams;
+		};
+
+		/**
+		 * A trigram of an entry, used while building.
+		 */
+		struct TrigramPair
+		{
+			/**
+			 * Trigram key.
+			 */
+			int trigram;
+
+			/**
+			 * Index of the entry.
+			 */
+			int entry;
+		};
+
+		/**
+		 * Used by search() to sort the candidates.
+		 */
+		friend struct CandidateCompare;
+
+		/**
+		 * Used by build() to sort the trigrams.
+		 */
+		friend struct TrigramPairCompare;
+
+		/**
+		 * Create the trigram lists.
+		 */
+		void build();
+
+		/**
+		 * Add the trigrams of a text to a given array.
+		 * @param text Null terminated text.
+		 * @param entry Index of the entry.
+		 * @param pairs The trigrams are added to this array.
+		 */
+		void addTrigrams(
+			const char* text,
+			const int entry,
+			MAUtil::Vector<TrigramPair>& pairs);
+
+		/**
+		 * Find a trigram.
+		 * @param trigram Trigram key.
+		 * @return Index in mTrigrams, or -1 if no entry contains it.
+		 */
+		int findTrigram(const int trigram) const;
+
+		/**
+		 * Compute the smallest edit distance between the searched text and
+		 * any part of a given text.
+		 * @param patternLength Length of the searched text. The masks of its
+		 * characters must be set in mPatternMasks.
+		 * @param text Null terminated text.
+		 * @return The distance.
+		 */
+		int computeDistance(const int patternLength, const char* text) const;
+
+	private:
+		/**
+		 * Table that contains the names and capitals.
+		 */
+		const CountrySummaryTable& mSummaryTable;
+
+		/**
+		 * Number of table rows used to build the index.
+		 */
+		int mCountIndexedRows;
+
+		/**
+		 * Trigram keys that appear in any entry, ascending.
+		 */
+		MAUtil::Vector<int> mTrigrams;
+
+		/**
+		 * Element i is the index in mTrigramEntries of the first entry that
+		 * contains mTrigrams[i]. Has an extra element at the end.
+		 */
+		MAUtil::Vector<int> mTrigramStarts;
+
+		/**
+		 * Entries that contain each trigram, grouped by trigram.
+		 * Entry 2 * id is the name of country id, entry 2 * id + 1 is its
+		 * capital.
+		 */
+		MAUtil::Vector<int> mTrigramEntries;
+
+		/**
+		 * Element i has bit j set if entry i contains letter 'a' + j.
+		 */
+		MAUtil::Vector<unsigned int> mEntryLetters;
+
+		/**
+		 * Element i is the number of trigrams shared by entry i with
+		 * the searched text. Valid only if mEntryStamps[i] is mStamp.
+		 */
+		MAUtil::Vector<int> mSharedCounts;
+
+		/**
+		 * Stamps used to avoid clearing mSharedCounts for each search.
+		 */
+		MAUtil::Vector<int> mEntryStamps;
+
+		/**
+		 * Element i is the smallest distance found for country i, or -1
+		 * if the country was returned. Valid only if mCountryStamps[i]
+		 * is mStamp.
+		 */
+		MAUtil::Vector<int> mCountryDistances;
+
+		/**
+		 * Stamps used to avoid clearing mCountryDistances for each search.
+		 */
+		MAUtil::Vector<int> mCountryStamps;
+
+		/**
+		 * Stamp of the current search.
+		 */
+		int mStamp;
+
+		/**
+		 * Element c has bit i set if character i of the searched text
+		 * is c.
+		 */
+		unsigned int mPatternMasks[256];
+
+	}; // end of CountryFuzzyIndex
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_FUZZY_INDEX_H_ */
@@ -0,0 +1,204 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryKeyIndex.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Hash tables used to find a country by its name, capital or
+ * file name.
+ */
+
+// Smallest number of slots of a table.
+#define MIN_COUNT_SLOTS 16
+
+#include "Country.h"
+#include "CountryKeyIndex.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Get the key of a country.
+	 * @param country Country to read.
+	 * @param field Field that contains the key.
+	 * @return Key value.
+	 */
+	static StringSlice getKey(
+		const Country& country,
+		const CountryKeyField field)
+	{
+		switch (field)
+		{
+		case CountryKeyName:
+			return country.getNameSlice();
+		case CountryKeyCapital:
+			return country.getCapitalSlice();
+		default:
+			return country.getFileNameSlice();
+		}
+	}
+
+	/**
+	 * Constructor.
+	 * @param countries Countries to index. The country at index i
+	 * must have id i.
+	 */
+	CountryKeyIndex::CountryKeyIndex(const MAUtil::Vector<Country*>& countries):
+		mCountries(countries),
+		mCountIndexedCountries(-1),
+		mSlotMask(0)
+	{
+	}
+
+	/**
+	 * Find a country.
+	 * @param field Field to check.
+	 * @param key Value of the field.
+	 * @param length Length of param key in bytes.
+	 * @return Id of the found country, or -1 if no country has the key.
+	 */
+	int CountryKeyIndex::find(
+		const CountryKeyField field,
+		const char* key,
+		const int length)
+	{
+		// Countries may have been added since the tables were built.
+		if (mCountIndexedCountries != mCountries.size())
+		{
+			this->build();
+		}
+		if (field < 0 || field >= CountryKeyCount)
+		{
+			return -1;
+		}
+
+		int slot = this->findSlot(field, key, length,
+			hashData(key, length, true));
+		return mSlots[field][slot];
+	}
+
+	/**
+	 * Remove the index. Must be called when the data changes.
+	 */
+	void CountryKeyIndex::invalidate()
+	{
+		for (int field = 0; field < CountryKeyCount; field++)
+		{
+			mSlots[field].clear();
+			mSlotHashes[field].clear();
+		}
+		mSlotMask = 0;
+		mCountIndexedCountries = -1;
+	}
+
+	/**
+	 * Create the hash tables.
+	 */
+	void CountryKeyIndex::build()
+	{
+		int countCountries = mCountries.size();
+		int countSlots = MIN_COUNT_SLOTS;
+		while (countSlots < 2 * countCountries)
+		{
+			countSlots *= 2;
+		}
+		mSlotMask = countSlots - 1;
+
+		for (int field = 0; field < CountryKeyCount; field++)
+		{
+			mSlots[field].resize(countSlots);
+			mSlotHashes[field].resize(countSlots);
+			for (int slot = 0; slot < countSlots; slot++)
+			{
+				mSlots[field][slot] = -1;
+			}
+			for (int countryID = 0; countryID < countCountries; countryID++)
+			{
+				this->insert((CountryKeyField) field, countryID);
+			}
+		}
+		mCountIndexedCountries = countCountries;
+	}
+
+	/**
+	 * Add a country to the table of a field.
+	 * @param field Field that contains the key.
+	 * @param countryID Id of the country.
+	 */
+	void CountryKeyIndex::insert(
+		const CountryKeyField field,
+		const int countryID)
+	{
+		StringSlice key = getKey(*mCountries[countryID], field);
+		unsigned int hash = hashData(key.text, key.length, true);
+		int slot = this->findSlot(field, key.text, key.length, hash);
+
+		// Countries are added in id order, so an existing key belongs
+		// to a smaller id and is kept.
+		if (mSlots[field][slot] < 0)
+		{
+			mSlots[field][slot] = countryID;
+			mSlotHashes[field][slot] = hash;
+		}
+	}
+
+	/**
+	 * Find the slot of a key.
+	 * @param field Field to check.
+	 * @param key Value of the field.
+	 * @param length Length of param key in bytes.
+	 * @param hash Hash of param key.
+	 * @return Index of the slot that contains the key, or of the empty
+	 * slot where it would be added.
+	 */
+	int CountryKeyIndex::findSlot(
+		const CountryKeyField field,
+		const char* key,
+		const int length,
+		const unsigned int hash) const
+	{
+		const MAUtil::Vector<int>& slots = mSlots[field];
+		const MAUtil::Vector<unsigned int>& hashes = mSlotHashes[field];
+
+		// Linear probing: a table is at most half full, so an empty slot
+		// is always found.
+		unsigned int slot = hash & mSlotMask;
+		while (slots[slot] >= 0)
+		{
+			if (hashes[slot] == hash)
+			{
+				StringSlice stored = getKey(*mCountries[slots[slot]], field);
+				bool equal = stored.length == length;
+				for (int index = 0; equal && index < length; index++)
+				{
+					equal = toLowerASCII(stored.text[index]) ==
+						toLowerASCII(key[index]);
+				}
+				if (equal)
+				{
+					break;
+				}
+			}
+			slot = (slot + 1) & mSlotMask;
+		}
+		return slot;
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryKeyIndex.h
+ * @author Bogdan Iusco
+ *
+ * @brief Hash tables used to find a country by its name, capital or
+ * file name.
+ */
+
+#ifndef EC_COUNTRY_KEY_INDEX_H_
+#define EC_COUNTRY_KEY_INDEX_H_
+
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	// Forward declarations for EuropeanCountries namespace classes.
+	class Country;
+
+	/**
+	 * Fields that identify a country.
+	 */
+	enum CountryKeyField
+	{
+		CountryKeyName = 0,
+		CountryKeyCapital,
+		CountryKeyFileName,
+		CountryKeyCount
+	};
+
+	/**
+	 * @brief Finds a country by the exact value of a key field, without
+	 * reading all countries.
+	 * Each field has an open addressing hash table that stores country ids.
+	 * The table has at least twice as many slots as countries, so a lookup
+	 * usually reads one or two slots. Case is ignored for ASCII letters.
+	 * If several countries have the same key, the one with the smallest
+	 * id is found.
+	 */
+	class CountryKeyIndex
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param countries Countries to index. The country at index i
+		 * must have id i.
+		 */
+		CountryKeyIndex(const MAUtil::Vector<Country*>& countries);
+
+		/**
+		 * Find a country.
+		 * @param field Field to check.
+		 * @param key Value of the field.
+		 * @param length Length of param key in bytes.
+		 * @return Id of the found country, or -1 if no country has the key.
+		 */
+		int find(
+			const CountryKeyField field,
+			const char* key,
+			const int length);
+
+		/**
+		 * Remove the index. Must be called when the data changes.
+		 */
+		void invalidate();
+
+	private:
+		/**
+		 * Create the hash tables.
+		 */
+		void build();
+
+		/**
+		 * Add a country to the table of a field.
+		 * @param field Field that contains the key.
+		 * @param countryID Id of the country.
+		 */
+		void insert(const CountryKeyField field, const int countryID);
+
+		/**
+		 * Find the slot of a key.
+		 * @param field Field to check.
+		 * @param key Value of the field.
+		 * @param length Length of param key in bytes.
+		 * @param hash Hash of param key.
+		 * @return Index of the slot that contains the key, or of the empty
+		 * slot where it would be added.
+		 */
+		int findSlot(
+			const CountryKeyField field,
+			const char* key,
+			const int length,
+			const unsigned int hash) const;
+
+	private:
+		/**
+		 * Countries to index.
+		 */
+		const MAUtil::Vector<Country*>& mCountries;
+
+		/**
+		 * Number of countries used to build the tables.
+		 */
+		int mCountIndexedCountries;
+
+		/**
+		 * Number of slots minus one. The number of slots is a power of two.
+		 */
+		unsigned int mSlotMask;
+
+		/**
+		 * Slots of each field. A slot holds a country id, or -1 if empty.
+		 */
+		MAUtil::Vector<int> mSlots[CountryKeyCount];
+
+		/**
+		 * Hash of the key stored in each slot, compared before the keys.
+		 */
+		MAUtil::Vector<unsigned int> mSlotHashes[CountryKeyCount];
+
+	}; // end of CountryKeyIndex
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_KEY_INDEX_H_ */
@@ -0,0 +1,179 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryLoadJob.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Reads and parses a range of country files.
+ */
+
+// Size of the string arena blocks of a job. A job holds few texts, so
+// its blocks are smaller than the ones of the database arena.
+#define LOAD_JOB_ARENA_BLOCK_SIZE (8 * 1024)
+
+#include <conprint.h>
+#include <mastdlib.h>
+
+#include "Country.h"
+#include "CountryLoadJob.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Constructor.
+	 * @param fileNames File names from the CountryTable file. The array
+	 * must exist while the job exists.
+	 * @param firstIndex Index of the first file read by the job.
+	 * @param endIndex Index after the last file read by the job.
+	 */
+	CountryLoadJob::CountryLoadJob(
+		const MAUtil::Vector<MAUtil::String>& fileNames,
+		const int firstIndex,
+		const int endIndex):
+		mFileNames(fileNames),
+		mFirstIndex(firstIndex),
+		mEndIndex(endIndex),
+		mStringArena(LOAD_JOB_ARENA_BLOCK_SIZE),
+		mCountryParser(mStringArena),
+		mAllFilesRead(true),
+		mBytesRead(0)
+	{
+	}
+
+	/**
+	 * Destructor.
+	 * Deletes the countries that were not taken.
+	 */
+	CountryLoadJob::~CountryLoadJob()
+	{
+		this->clear();
+	}
+
+	/**
+	 * Read and parse the files of the job. Results of a previous call
+	 * are removed. A file that cannot be read or parsed is skipped.
+	 * @param fileReader Used to read the files.
+	 * @return true if all files were read, false otherwise.
+	 */
+	bool CountryLoadJob::run(IFileReader& fileReader)
+	{
+		this->clear();
+		mCountries.reserve(mEndIndex - mFirstIndex);
+		mAllFilesRead = true;
+
+		fileReader.readTextFromFiles(mFileNames, mFirstIndex, mEndIndex, *this);
+		return mAllFilesRead;
+	}
+
+	/**
+	 * Parse a file of the job.
+	 * From IFileBatchListener.
+	 * @param index Index of the file in the CountryTable.
+	 * @param content File content, or NULL if the file could not
+	 * be read.
+	 * @param size Content size in bytes.
+	 */
+	void CountryLoadJob::fileRead(
+		const int index,
+		const char* content,
+		const int size)
+	{
+		const MAUtil::String& fileName = mFileNames[index];
+		if (!content)
+		{
+			printf("Cannot read text from %s", fileName.c_str());
+			mAllFilesRead = false;
+			return;
+		}
+		mBytesRead += size;
+
+		// The id is the position in the CountryTable file. The database
+		// changes it if a previous file was skipped.
+		Country* country = new Country(index);
+		country->setFileName(mStringArena.add(
+			fileName.c_str(), fileName.size()));
+		if (mCountryParser.parseCountry(content, size, *country,
+			CountrySummaryFields))
+		{
+			mCountries.add(country);
+		}
+		else
+		{
+			printf("Cannot parse %s", fileName.c_str());
+			delete country;
+		}
+	}
+
+	/**
+	 * Get the countries created by run(), in CountryTable order.
+	 * Country ids are the indexes of their files in the CountryTable.
+	 * @return The countries. They are owned by the job until
+	 * takeResults() is called.
+	 */
+	const MAUtil::Vector<Country*>& CountryLoadJob::getCountries() const
+	{
+		return mCountries;
+	}
+
+	/**
+	 * Pass the ownership of the countries to the caller. The job is
+	 * left empty.
+	 * @param stringArena The texts of the countries are copied to this
+	 * arena. A job fills only a small part of its arena blocks, so the
+	 * blocks are released instead of being kept by the caller.
+	 * @param outCountries The countries are added to this array.
+	 */
+	void CountryLoadJob::takeResults(
+		StringArena& stringArena,
+		MAUtil::Vector<Country*>& outCountries)
+	{
+		for (int index = 0; index < mCountries.size(); index++)
+		{
+			mCountries[index]->copySummaryTexts(stringArena);
+			outCountries.add(mCountries[index]);
+		}
+		mCountries.clear();
+		mStringArena.clear();
+	}
+
+	/**
+	 * Get the number of bytes read by the last run() call.
+	 * @return Size in bytes.
+	 */
+	int CountryLoadJob::getBytesRead() const
+	{
+		return mBytesRead;
+	}
+
+	/**
+	 * Delete the countries and release their texts.
+	 */
+	void CountryLoadJob::clear()
+	{
+		for (int index = 0; index < mCountries.size(); index++)
+		{
+			delete mCountries[index];
+		}
+		mCountries.clear();
+		mStringArena.clear();
+		mBytesRead = 0;
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,171 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryLoadJob.h
+ * @author Bogdan Iusco
+ *
+ * @brief Reads and parses a range of country files.
+ */
+
+#ifndef EC_COUNTRY_LOAD_JOB_H_
+#define EC_COUNTRY_LOAD_JOB_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+#include "CountryParser.h"
+#include "IFileReader.h"
+#include "StringArena.h"
+
+namespace EuropeanCountries
+{
+
+	// Forward declarations for EuropeanCountries namespace classes.
+	class Country;
+
+	/**
+	 * @brief Reads and parses the country files listed in a range of the
+	 * CountryTable file.
+	 * A job writes only to its own parser, string arena and countries, so
+	 * jobs do not depend on each other and can run in any order. The
+	 * database merges their results in CountryTable order.
+	 * The files are read as one batch, and each file is parsed as soon
+	 * as the reader passes it to the job.
+	 */
+	class CountryLoadJob:
+		public IFileBatchListener
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param fileNames File names from the CountryTable file. The array
+		 * must exist while the job exists.
+		 * @param firstIndex Index of the first file read by the job.
+		 * @param endIndex Index after the last file read by the job.
+		 */
+		CountryLoadJob(
+			const MAUtil::Vector<MAUtil::String>& fileNames,
+			const int firstIndex,
+			const int endIndex);
+
+		/**
+		 * Destructor.
+		 * Deletes the countries that were not taken.
+		 */
+		virtual ~CountryLoadJob();
+
+		/**
+		 * Read and parse the files of the job. Results of a previous call
+		 * are removed. A file that cannot be read or parsed is skipped.
+		 * @param fileReader Used to read the files.
+		 * @return true if all files were read, false otherwise.
+		 */
+		bool run(IFileReader& fileReader);
+
+		/**
+		 * Parse a file of the job.
+		 * From IFileBatchListener.
+		 * @param index Index of the file in the CountryTable.
+		 * @param content File content, or NULL if the file could not
+		 * be read.
+		 * @param size Content size in bytes.
+		 */
+		virtual void fileRead(
+			const int index,
+			const char* content,
+			const int size);
+
+		/**
+		 * Get the countries created by run(), in CountryTable order.
+		 * Country ids are the indexes of their files in the CountryTable.
+		 * @return The countries. They are owned by the job until
+		 * takeResults() is called.
+		 */
+		const MAUtil::Vector<Country*>& getCountries() const;
+
+		/**
+		 * Pass the ownership of the countries to the caller. The job is
+		 * left empty.
+		 * @param stringArena The texts of the countries are copied to this
+		 * arena. A job fills only a small part of its arena blocks, so the
+		 * blocks are released instead of being kept by the caller.
+		 * @param outCountries The countries are added to this array.
+		 */
+		void takeResults(
+			StringArena& stringArena,
+			MAUtil::Vector<Country*>& outCountries);
+
+		/**
+		 * Get the number of bytes read by the last run() call.
+		 * @return Size in bytes.
+		 */
+		int getBytesRead() const;
+
+	private:
+		/**
+		 * Delete the countries and release their texts.
+		 */
+		void clear();
+
+	private:
+		/**
+		 * File names from the CountryTable file.
+		 */
+		const MAUtil::Vector<MAUtil::String>& mFileNames;
+
+		/**
+		 * Index of the first file read by the job.
+		 */
+		int mFirstIndex;
+
+		/**
+		 * Index after the last file read by the job.
+		 */
+		int mEndIndex;
+
+		/**
+		 * Stores the texts of the summary fields of the countries.
+		 */
+		StringArena mStringArena;
+
+		/**
+		 * Used to parse the country files.
+		 */
+		CountryParser mCountryParser;
+
+		/**
+		 * Countries created by run().
+		 */
+		MAUtil::Vector<Country*> mCountries;
+
+		/**
+		 * False if a file could not be read by run().
+		 */
+		bool mAllFilesRead;
+
+		/**
+		 * Number of bytes read by run().
+		 */
+		int mBytesRead;
+
+	}; // end of CountryLoadJob
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_LOAD_JOB_H_ */
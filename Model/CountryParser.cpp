@@ -0,0 +1,362 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryParser.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Single pass parser for the CountryTable file and country files.
+ */
+
+#include <mastdlib.h>
+#include <yajl/yajl_parse.h>
+
+#include "Country.h"
+#include "CountryParser.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Fields that can be read by the parser.
+	 */
+	enum ParserField
+	{
+		ParserFieldNone = 0,
+		ParserFieldCountries,
+		ParserFieldName,
+		ParserFieldFlagID,
+		ParserFieldPopulation,
+		ParserFieldArea,
+		ParserFieldLanguages,
+		ParserFieldGovernment,
+		ParserFieldCapital
+	};
+
+	/**
+	 * Constructor.
+	 * @param stringArena Texts of the summary fields are copied into
+	 * this arena. It must exist while the parsed countries exist.
+	 */
+	CountryParser::CountryParser(StringArena& stringArena):
+		mCountry(NULL),
+		mCountryFileNames(NULL),
+		mCurrentField(ParserFieldNone),
+		mFields(CountryAllFields),
+		mStringArena(stringArena),
+		mDepth(0)
+	{
+	}
+
+	/**
+	 * Parse the content of a country file.
+	 * @param text File content.
+	 * @param length Content length in bytes.
+	 * @param country Fields found in the file will be set on this object.
+	 * @param fields Fields to read(CountryFields values). Other fields
+	 * found in the file are skipped.
+	 * @return true if the content is valid JSON, false otherwise.
+	 */
+	bool CountryParser::parseCountry(
+		const char* text,
+		const int length,
+		Country& country,
+		const int fields)
+	{
+		mCountry = &country;
+		mCountryFileNames = NULL;
+		mFields = fields;
+		bool result = this->parse(text, length);
+		if (result && (fields & CountryDetailFields))
+		{
+			country.setHasDetails(true);
+		}
+		mCountry = NULL;
+		mFields = CountryAllFields;
+		return result;
+	}
+
+	/**
+	 * Parse the content of the CountryTable file.
+	 * @param text File content.
+	 * @param length Content length in bytes.
+	 * @param countryFileNames File names found in the table will be added
+	 * to this array.
+	 * @return true if the content is valid JSON, false otherwise.
+	 */
+	bool CountryParser::parseCountryTable(
+		const char* text,
+		const int length,
+		MAUtil::Vector<MAUtil::String>& countryFileNames)
+	{
+		mCountry = NULL;
+		mCountryFileNames = &countryFileNames;
+		bool result = this->parse(text, length);
+		mCountryFileNames = NULL;
+		return result;
+	}
+
+	/**
+	 * Run YAJL over a given text.
+	 * @param text Text to parse.
+	 * @param length Text length in bytes.
+	 * @return true if the content is valid JSON, false otherwise.
+	 */
+	bool CountryParser::parse(const char* text, const int length)
+	{
+		mCurrentField = ParserFieldNone;
+		mDepth = 0;
+
+		// Values that are not used(null, booleans, doubles) are ignored.
+		yajl_callbacks callbacks;
+		memset(&callbacks, 0, sizeof(callbacks));
+		callbacks.yajl_integer = CountryParser::onInteger;
+		callbacks.yajl_string = CountryParser::onString;
+		callbacks.yajl_start_map = CountryParser::onStartMap;
+		callbacks.yajl_map_key = CountryParser::onMapKey;
+		callbacks.yajl_end_map = CountryParser::onEndMap;
+		callbacks.yajl_start_array = CountryParser::onStartArray;
+		callbacks.yajl_end_array = CountryParser::onEndArray;
+
+		yajl_parser_config config = { 0, 0 };
+		yajl_handle handle = yajl_alloc(&callbacks, &config, NULL, this);
+		yajl_status status = yajl_parse(
+			handle, (const unsigned char*) text, length);
+		if (status == yajl_status_ok || status == yajl_status_insufficient_data)
+		{
+			status = yajl_parse_complete(handle);
+		}
+		yajl_free(handle);
+
+		return status == yajl_status_ok;
+	}
+
+	/**
+	 * Called by YAJL for integer values.
+	 * @param context The CountryParser object.
+	 * @param value Parsed value.
+	 * @return Non zero to continue parsing.
+	 */
+	int CountryParser::onInteger(void* context, long value)
+	{
+		CountryParser* parser = (CountryParser*) context;
+		if (parser->mCountry &&
+			parser->mCurrentField == ParserFieldFlagID &&
+			(parser->mFields & CountrySummaryFields))
+		{
+			parser->mCountry->setFlagID((int) value);
+		}
+		parser->mCurrentField = ParserFieldNone;
+		return 1;
+	}
+
+	/**
+	 * Called by YAJL for string values.
+	 * @param context The CountryParser object.
+	 * @param value Parsed value. It is not null terminated.
+	 * @param length Value length.
+	 * @return Non zero to continue parsing.
+	 */
+	int CountryParser::onString(
+		void* context,
+		const unsigned char* value,
+		unsigned int length)
+	{
+		CountryParser* parser = (CountryParser*) context;
+		if (parser->mCountryFileNames)
+		{
+			// Only strings inside the countries array are file names.
+			if (parser->mCurrentField == ParserFieldCountries && parser->mDepth == 2)
+			{
+				parser->mCountryFileNames->add(
+					MAUtil::String((const char*) value, length));
+			}
+			return 1;
+		}
+
+		// Skip values of fields that were not requested.
+		bool isDetailField =
+			parser->mCurrentField == ParserFieldLanguages ||
+			parser->mCurrentField == ParserFieldGovernment;
+		int fieldGroup = isDetailField ? CountryDetailFields : CountrySummaryFields;
+		if (!(parser->mFields & fieldGroup))
+		{
+			parser->mCurrentField = ParserFieldNone;
+			return 1;
+		}
+
+		// Summary texts are stored in the arena, detail texts are owned
+		// by the country.
+		const char* text = (const char*) value;
+		StringArena& arena = parser->mStringArena;
+		Country* country = parser->mCountry;
+		switch (parser->mCurrentField)
+		{
+		case ParserFieldName:
+			country->setName(arena.add(text, length));
+			break;
+		case ParserFieldPopulation:
+			country->setPopulation(arena.add(text, length));
+			break;
+		case ParserFieldArea:
+			country->setArea(arena.add(text, length));
+			break;
+		case ParserFieldLanguages:
+			country->setLanguages(MAUtil::String(text, length));
+			break;
+		case ParserFieldGovernment:
+			country->setGovernment(MAUtil::String(text, length));
+			break;
+		case ParserFieldCapital:
+			country->setCapital(arena.add(text, length));
+			break;
+		default:
+			break;
+		}
+		parser->mCurrentField = ParserFieldNone;
+		return 1;
+	}
+
+	/**
+	 * Called by YAJL when a map starts.
+	 * @param context The CountryParser object.
+	 * @return Non zero to continue parsing.
+	 */
+	int CountryParser::onStartMap(void* context)
+	{
+		CountryParser* parser = (CountryParser*) context;
+		parser->mDepth++;
+		return 1;
+	}
+
+	/**
+	 * Called by YAJL for map keys.
+	 * Only keys from the root map are used.
+	 * @param context The CountryParser object.
+	 * @param key Parsed key. It is not null terminated.
+	 * @param length Key length.
+	 * @return Non zero to continue parsing.
+	 */
+	int CountryParser::onMapKey(
+		void* context,
+		const unsigned char* key,
+		unsigned int length)
+	{
+		CountryParser* parser = (CountryParser*) context;
+		parser->mCurrentField = ParserFieldNone;
+		if (parser->mDepth != 1)
+		{
+			return 1;
+		}
+
+		if (parser->mCountryFileNames)
+		{
+			if (isKey(key, length, sCountriesKey))
+			{
+				parser->mCurrentField = ParserFieldCountries;
+			}
+		}
+		else if (isKey(key, length, sCountryNameKey))
+		{
+			parser->mCurrentField = ParserFieldName;
+		}
+		else if (isKey(key, length, sCountryFlagIDKey))
+		{
+			parser->mCurrentField = ParserFieldFlagID;
+		}
+		else if (isKey(key, length, sCountryPopulationKey))
+		{
+			parser->mCurrentField = ParserFieldPopulation;
+		}
+		else if (isKey(key, length, sCountryAreaKey))
+		{
+			parser->mCurrentField = ParserFieldArea;
+		}
+		else if (isKey(key, length, sCountryLanguagesKey))
+		{
+			parser->mCurrentField = ParserFieldLanguages;
+		}
+		else if (isKey(key, length, sCountryGovernmentKey))
+		{
+			parser->mCurrentField = ParserFieldGovernment;
+		}
+		else if (isKey(key, length, sCountryCapitalKey))
+		{
+			parser->mCurrentField = ParserFieldCapital;
+		}
+		return 1;
+	}
+
+	/**
+	 * Called by YAJL when a map ends.
+	 * @param context The CountryParser object.
+	 * @return Non zero to continue parsing.
+	 */
+	int CountryParser::onEndMap(void* context)
+	{
+		CountryParser* parser = (CountryParser*) context;
+		parser->mDepth--;
+		parser->mCurrentField = ParserFieldNone;
+		return 1;
+	}
+
+	/**
+	 * Called by YAJL when an array starts.
+	 * The current field is kept, so strings from the countries array
+	 * can be identified.
+	 * @param context The CountryParser object.
+	 * @return Non zero to continue parsing.
+	 */
+	int CountryParser::onStartArray(void* context)
+	{
+		CountryParser* parser = (CountryParser*) context;
+		parser->mDepth++;
+		return 1;
+	}
+
+	/**
+	 * Called by YAJL when an array ends.
+	 * @param context The CountryParser object.
+	 * @return Non zero to continue parsing.
+	 */
+	int CountryParser::onEndArray(void* context)
+	{
+		CountryParser* parser = (CountryParser*) context;
+		parser->mDepth--;
+		parser->mCurrentField = ParserFieldNone;
+		return 1;
+	}
+
+	/**
+	 * Check if a key sent by YAJL is equal to a given key.
+	 * @param key Key sent by YAJL. It is not null terminated.
+	 * @param length Key length.
+	 * @param expectedKey Null terminated key.
+	 * @return true if keys are equal, false otherwise.
+	 */
+	bool CountryParser::isKey(
+		const unsigned char* key,
+		const unsigned int length,
+		const char* expectedKey)
+	{
+		return strlen(expectedKey) == length &&
+			memcmp(key, expectedKey, length) == 0;
+	}
+
+} // end of EuropeanCountries
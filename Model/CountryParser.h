@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryParser.h
+ * @author Bogdan Iusco
+ *
+ * @brief Single pass parser for the CountryTable file and country files.
+ */
+
+#ifndef EC_COUNTRY_PARSER_H_
+#define EC_COUNTRY_PARSER_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+#include "Country.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Parses JSON data files using YAJL callbacks.
+	 * No JSON tree is created: values are written into the destination
+	 * object as soon as the parser reaches them.
+	 */
+	class CountryParser
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param stringArena Texts of the summary fields are copied into
+		 * this arena. It must exist while the parsed countries exist.
+		 */
+		CountryParser(StringArena& stringArena);
+
+		/**
+		 * Parse the content of a country file.
+		 * @param text File content.
+		 * @param length Content length in bytes.
+		 * @param country Fields found in the file will be set on this object.
+		 * @param fields Fields to read(CountryFields values). Other fields
+		 * found in the file are skipped.
+		 * @return true if the content is valid JSON, false otherwise.
+		 */
+		bool parseCountry(
+			const char* text,
+			const int length,
+			Country& country,
+			const int fields = CountryAllFields);
+
+		/**
+		 * Parse the content of the CountryTable file.
+		 * @param text File content.
+		 * @param length Content length in bytes.
+		 * @param countryFileNames File names found in the table will be added
+		 * to this array.
+		 * @return true if the content is valid JSON, false otherwise.
+		 */
+		bool parseCountryTable(
+			const char* text,
+			const int length,
+			MAUtil::Vector<MAUtil::String>& countryFileNames);
+
+	private:
+		/**
+		 * Run YAJL over a given text.
+		 * @param text Text to parse.
+		 * @param length Text length in bytes.
+		 * @return true if the content is valid JSON, false otherwise.
+		 */
+		bool parse(const char* text, const int length);
+
+		/**
+		 * YAJL callbacks. The context is the CountryParser object.
+		 */
+		static int onInteger(void* context, long value);
+		static int onString(
+			void* context,
+			const unsigned char* value,
+			unsigned int length);
+		static int onStartMap(void* context);
+		static int onMapKey(
+			void* context,
+			const unsigned char* key,
+			unsigned int length);
+		static int onEndMap(void* context);
+		static int onStartArray(void* context);
+		static int onEndArray(void* context);
+
+		/**
+		 * Check if a key sent by YAJL is equal to a given key.
+		 * @param key Key sent by YAJL. It is not null terminated.
+		 * @param length Key length.
+		 * @param expectedKey Null terminated key.
+		 * @return true if keys are equal, false otherwise.
+		 */
+		static bool isKey(
+			const unsigned char* key,
+			const unsigned int length,
+			const char* expectedKey);
+
+	private:
+		/**
+		 * Country that receives values, if a country file is parsed.
+		 */
+		Country* mCountry;
+
+		/**
+		 * Array that receives file names, if the CountryTable file is parsed.
+		 */
+		MAUtil::Vector<MAUtil::String>* mCountryFileNames;
+
+		/**
+		 * Identifies the field of the value that will be parsed next.
+		 * One of the CountryParser.cpp field constants.
+		 */
+		int mCurrentField;
+
+		/**
+		 * Fields read from a country file(CountryFields values).
+		 */
+		int mFields;
+
+		/**
+		 * Stores the texts of the summary fields.
+		 */
+		StringArena& mStringArena;
+
+		/**
+		 * Number of maps and arrays that contain the current value.
+		 */
+		int mDepth;
+
+	}; // end of CountryParser
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_PARSER_H_ */
@@ -0,0 +1,348 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountrySearchIndex.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Prefix search over country and capital names.
+ */
+
+// If more than 1/ORDER_WALK_RATIO of the listed countries are found, the
+// results are collected by walking the order instead of sorting them.
+#define ORDER_WALK_RATIO 16
+
+#include "CountrySearchIndex.h"
+#include "CountrySummaryTable.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Check if a character separates words.
+	 * @param c Character to check.
+	 * @return true if the character separates words, false otherwise.
+	 */
+	static inline bool isWordSeparator(const char c)
+	{
+		return c == ' ' || c == '-' || c == '(' || c == '/' || c == '\'';
+	}
+
+	/**
+	 * Compares two words for mergeSort(), ignoring the case of ASCII letters.
+	 */
+	struct WordCompare
+	{
+		int operator()(
+			const CountrySearchIndex::Word& first,
+			const CountrySearchIndex::Word& second) const
+		{
+			const char* a = first.text;
+			const char* b = second.text;
+			while (*a && toLowerASCII(*a) == toLowerASCII(*b))
+			{
+				a++;
+				b++;
+			}
+			return (int) toLowerASCII(*a) - (int) toLowerASCII(*b);
+		}
+	};
+
+	/**
+	 * Compares two positions in the result order for mergeSort().
+	 */
+	struct PositionCompare
+	{
+		int operator()(const int first, const int second) const
+		{
+			return first - second;
+		}
+	};
+
+	/**
+	 * Constructor.
+	 * @param summaryTable Table that contains the names and capitals.
+	 */
+	CountrySearchIndex::CountrySearchIndex(
+		const CountrySummaryTable& summaryTable):
+		mSummaryTable(summaryTable),
+		mCountIndexedRows(-1),
+		mStamp(0),
+		mOrderVersion(-1)
+	{
+	}
+
+	/**
+	 * Find the countries that match a given text.
+	 * @param text Text typed by the user.
+	 * @param order Country ids in the order used by the list
+	 * (e.g. from ICountryDatabase::getSortedCountryIDs()).
+	 * @param orderVersion Number that changes each time the content of
+	 * param order changes, or -1 if it is not known. The position of
+	 * each id in the order is computed again only when the version
+	 * changes or it is -1.
+	 * @param outMatches Will contain a match for each found country, in
+	 * the order given by param order. A name match is preferred to a
+	 * capital match.
+	 */
+	void CountrySearchIndex::search(
+		const MAUtil::String& text,
+		const MAUtil::Vector<int>& order,
+		const int orderVersion,
+		MAUtil::Vector<CountryMatch>& outMatches)
+	{
+		outMatches.clear();
+
+		// Rows may have been added since the index was built.
+		if (mCountIndexedRows != mSummaryTable.countRows())
+		{
+			this->build();
+		}
+		this->setQuery(text);
+		this->setOrder(order, orderVersion);
+
+		// Mark the countries that have a word in the found range. Each
+		// country is added once to the found positions.
+		mStamp++;
+		mFoundPositions.clear();
+		int rangeEnd = mRangeEnds[mQuery.length()];
+		for (int index = mRangeStarts[mQuery.length()]; index < rangeEnd; index++)
+		{
+			int countryID = mWords[index].countryID;
+			if (mMatchStamps[countryID] != mStamp)
+			{
+				mMatchStamps[countryID] = mStamp;
+				mMatchWords[countryID] = index;
+				if (mOrderPositions[countryID] >= 0)
+				{
+					mFoundPositions.add(mOrderPositions[countryID]);
+				}
+			}
+			else if (mWords[index].field == CountrySearchName &&
+				mWords[mMatchWords[countryID]].field != CountrySearchName)
+			{
+				mMatchWords[countryID] = index;
+			}
+		}
+
+		// Collect the matches in list order. Few matches are sorted by
+		// their positions, many are found by walking the whole order.
+		bool walkOrder =
+			mFoundPositions.size() > order.size() / ORDER_WALK_RATIO;
+		if (!walkOrder && mFoundPositions.size() > 1)
+		{
+			PositionCompare compare;
+			mergeSort(&mFoundPositions[0], mFoundPositions.size(), compare);
+		}
+		outMatches.reserve(mFoundPositions.size());
+		int countPositions = walkOrder ? order.size() : mFoundPositions.size();
+		for (int index = 0; index < countPositions; index++)
+		{
+			int countryID = walkOrder ? order[index] :
+				order[mFoundPositions[index]];
+			if (walkOrder &&
+				(countryID < 0 || countryID >= mCountIndexedRows ||
+				mMatchStamps[countryID] != mStamp))
+			{
+				continue;
+			}
+
+			const Word& word = mWords[mMatchWords[countryID]];
+			CountryMatch match;
+			match.countryID = countryID;
+			match.field = word.field;
+			match.position = word.position;
+			match.length = mQuery.length();
+			outMatches.add(match);
+		}
+	}
+
+	/**
+	 * Remove the index. Must be called when the data changes.
+	 */
+	void CountrySearchIndex::invalidate()
+	{
+		mWords.clear();
+		mMatchWords.clear();
+		mMatchStamps.clear();
+		mRangeStarts.clear();
+		mRangeEnds.clear();
+		mQuery = "";
+		mCountIndexedRows = -1;
+		mOrderVersion = -1;
+		mOrderPositions.clear();
+		mFoundPositions.clear();
+	}
+
+	/**
+	 * Create the sorted array of words.
+	 */
+	void CountrySearchIndex::build()
+	{
+		this->invalidate();
+
+		int countRows = mSummaryTable.countRows();
+		for (int countryID = 0; countryID < countRows; countryID++)
+		{
+			this->addWords(mSummaryTable.getName(countryID).text,
+				countryID, CountrySearchName);
+			this->addWords(mSummaryTable.getCapital(countryID).text,
+				countryID, CountrySearchCapital);
+			mMatchWords.add(0);
+			mMatchStamps.add(0);
+			mOrderPositions.add(-1);
+		}
+		if (mWords.size() > 0)
+		{
+			WordCompare compare;
+			mergeSort(&mWords[0], mWords.size(), compare);
+		}
+		mCountIndexedRows = countRows;
+		mStamp = 0;
+
+		// The empty prefix matches all words.
+		mRangeStarts.add(0);
+		mRangeEnds.add(mWords.size());
+	}
+
+	/**
+	 * Add the words of a given text.
+	 * @param text Null terminated text.
+	 * @param countryID Id of the country.
+	 * @param field Field that contains the text.
+	 */
+	void CountrySearchIndex::addWords(
+		const char* text,
+		const int countryID,
+		const int field)
+	{
+		for (int position = 0; text[position]; position++)
+		{
+			if (isWordSeparator(text[position]) ||
+				(position > 0 && !isWordSeparator(text[position - 1])))
+			{
+				continue;
+			}
+
+			Word word;
+			word.text = text + position;
+			word.countryID = countryID;
+			word.field = field;
+			word.position = position;
+			mWords.add(word);
+		}
+	}
+
+	/**
+	 * Set the searched text. The ranges of the common prefix with the
+	 * previous text are reused.
+	 * @param text Text typed by the user.
+	 */
+	void CountrySearchIndex::setQuery(const MAUtil::String& text)
+	{
+		// Keep the ranges of the common prefix.
+		int commonLength = 0;
+		while (commonLength < text.length() &&
+			commonLength < mQuery.length() &&
+			toLowerASCII(text[commonLength]) == (unsigned char) mQuery[commonLength])
+		{
+			commonLength++;
+		}
+		mQuery.resize(commonLength);
+		mRangeStarts.resize(commonLength + 1);
+		mRangeEnds.resize(commonLength + 1);
+
+		// Narrow the range for each new character. All words in the range
+		// of a prefix start with that prefix, so they are sorted by their
+		// next character.
+		for (int position = commonLength; position < text.length(); position++)
+		{
+			unsigned char c = toLowerASCII(text[position]);
+			int start = mRangeStarts[position];
+			int end = mRangeEnds[position];
+
+			// First word with a character >= c.
+			int low = start;
+			int high = end;
+			while (low < high)
+			{
+				int middle = (low + high) / 2;
+				if (toLowerASCII(mWords[middle].text[position]) < c)
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+			start = low;
+
+			// First word with a character > c.
+			high = end;
+			while (low < high)
+			{
+				int middle = (low + high) / 2;
+				if (toLowerASCII(mWords[middle].text[position]) <= c)
+				{
+					low = middle + 1;
+				}
+				else
+				{
+					high = middle;
+				}
+			}
+
+			mQuery.append((const char*) &c, 1);
+			mRangeStarts.add(start);
+			mRangeEnds.add(low);
+		}
+	}
+
+	/**
+	 * Set the order of the results. The positions of the ids are
+	 * computed only if the order version changed or it is -1.
+	 * @param order Country ids in the order used by the list.
+	 * @param orderVersion Version of param order, -1 if not known.
+	 */
+	void CountrySearchIndex::setOrder(
+		const MAUtil::Vector<int>& order,
+		const int orderVersion)
+	{
+		if (orderVersion >= 0 && orderVersion == mOrderVersion)
+		{
+			return;
+		}
+
+		for (int countryID = 0; countryID < mOrderPositions.size(); countryID++)
+		{
+			mOrderPositions[countryID] = -1;
+		}
+		for (int index = 0; index < order.size(); index++)
+		{
+			int countryID = order[index];
+			if (countryID >= 0 && countryID < mCountIndexedRows)
+			{
+				mOrderPositions[countryID] = index;
+			}
+		}
+		mOrderVersion = orderVersion;
+	}
+
+} // end of EuropeanCountries
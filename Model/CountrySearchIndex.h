@@ -0,0 +1,249 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountrySearchIndex.h
+ * @author Bogdan Iusco
+ *
+ * @brief Prefix search over country and capital names.
+ */
+
+#ifndef EC_COUNTRY_SEARCH_INDEX_H_
+#define EC_COUNTRY_SEARCH_INDEX_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	// Forward declarations for EuropeanCountries namespace classes.
+	class CountrySummaryTable;
+
+	/**
+	 * Fields searched by CountrySearchIndex.
+	 */
+	enum CountrySearchField
+	{
+		CountrySearchName = 0,
+		CountrySearchCapital
+	};
+
+	/**
+	 * @brief A country found by a search.
+	 */
+	struct CountryMatch
+	{
+		/**
+		 * Id of the found country.
+		 */
+		int countryID;
+
+		/**
+		 * Field that contains the searched text(CountrySearchField value).
+		 */
+		int field;
+
+		/**
+		 * Position of the searched text in the field.
+		 */
+		int position;
+
+		/**
+		 * Length of the searched text.
+		 */
+		int length;
+	};
+
+	/**
+	 * @brief Finds the countries whose name or capital contains a word that
+	 * starts with a given text. Case is ignored for ASCII letters.
+	 * All word starts are kept in an array sorted by the text that follows
+	 * them, so the words with a given prefix are in a contiguous range.
+	 * The ranges found for each prefix of the last query are kept: typing
+	 * one more character only searches inside the previous range and
+	 * deleting a character needs no search. Only the words in the found
+	 * range are visited to collect the results.
+	 */
+	class CountrySearchIndex
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param summaryTable Table that contains the names and capitals.
+		 */
+		CountrySearchIndex(const CountrySummaryTable& summaryTable);
+
+		/**
+		 * Find the countries that match a given text.
+		 * @param text Text typed by the user.
+		 * @param order Country ids in the order used by the list
+		 * (e.g. from ICountryDatabase::getSortedCountryIDs()).
+		 * @param orderVersion Number that changes each time the content of
+		 * param order changes, or -1 if it is not known. The position of
+		 * each id in the order is computed again only when the version
+		 * changes or it is -1.
+		 * @param outMatches Will contain a match for each found country, in
+		 * the order given by param order. A name match is preferred to a
+		 * capital match.
+		 */
+		void search(
+			const MAUtil::String& text,
+			const MAUtil::Vector<int>& order,
+			const int orderVersion,
+			MAUtil::Vector<CountryMatch>& outMatches);
+
+		/**
+		 * Remove the index. Must be called when the data changes.
+		 */
+		void invalidate();
+
+	private:
+		/**
+		 * A word start in a name or capital.
+		 */
+		struct Word
+		{
+			/**
+			 * Null terminated text that starts with the word.
+			 */
+			const char* text;
+
+			/**
+			 * Id of the country.
+			 */
+			int countryID;
+
+			/**
+			 * Field that contains the word(CountrySearchField value).
+			 */
+			int field;
+
+			/**
+			 * Position of the word in the field.
+			 */
+			int position;
+		};
+
+		/**
+		 * Used by build() to compare words.
+		 */
+		friend struct WordCompare;
+
+		/**
+		 * Create the sorted array of words.
+		 */
+		void build();
+
+		/**
+		 * Add the words of a given text.
+		 * @param text Null terminated text.
+		 * @param countryID Id of the country.
+		 * @param field Field that contains the text.
+		 */
+		void addWords(const char* text, const int countryID, const int field);
+
+		/**
+		 * Set the searched text. The ranges of the common prefix with the
+		 * previous text are reused.
+		 * @param text Text typed by the user.
+		 */
+		void setQuery(const MAUtil::String& text);
+
+		/**
+		 * Set the order of the results. The positions of the ids are
+		 * computed only if the order version changed or it is -1.
+		 * @param order Country ids in the order used by the list.
+		 * @param orderVersion Version of param order, -1 if not known.
+		 */
+		void setOrder(
+			const MAUtil::Vector<int>& order,
+			const int orderVersion);
+
+	private:
+		/**
+		 * Table that contains the names and capitals.
+		 */
+		const CountrySummaryTable& mSummaryTable;
+
+		/**
+		 * Word starts sorted by the lower case text that follows them.
+		 */
+		MAUtil::Vector<Word> mWords;
+
+		/**
+		 * Number of table rows used to build mWords.
+		 */
+		int mCountIndexedRows;
+
+		/**
+		 * Lower case text of the last query.
+		 */
+		MAUtil::String mQuery;
+
+		/**
+		 * Element i is the first word that starts with the first i
+		 * characters of mQuery.
+		 */
+		MAUtil::Vector<int> mRangeStarts;
+
+		/**
+		 * Element i is the index after the last word that starts with the
+		 * first i characters of mQuery.
+		 */
+		MAUtil::Vector<int> mRangeEnds;
+
+		/**
+		 * Element i is the index in mWords of the match found for country i,
+		 * valid only if mMatchStamps[i] is equal to mStamp.
+		 */
+		MAUtil::Vector<int> mMatchWords;
+
+		/**
+		 * Stamps used to avoid clearing mMatchWords for each search.
+		 */
+		MAUtil::Vector<int> mMatchStamps;
+
+		/**
+		 * Stamp of the current search.
+		 */
+		int mStamp;
+
+		/**
+		 * Version of the order used to compute mOrderPositions, -1 if
+		 * they must be computed by the next search.
+		 */
+		int mOrderVersion;
+
+		/**
+		 * Element i is the position of country i in the order used by
+		 * the last search, or -1 if the order does not contain it.
+		 */
+		MAUtil::Vector<int> mOrderPositions;
+
+		/**
+		 * Positions in the order of the countries found by the current
+		 * search.
+		 */
+		MAUtil::Vector<int> mFoundPositions;
+
+	}; // end of CountrySearchIndex
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_SEARCH_INDEX_H_ */
@@ -0,0 +1,348 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountrySnapshot.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Binary image that contains all country data.
+ */
+
+// "ECDB" in little endian.
+#define SNAPSHOT_MAGIC 0x42444345
+#define SNAPSHOT_VERSION 2
+
+#include <conprint.h>
+#include <mastdlib.h>
+
+#include "Country.h"
+#include "CountrySnapshot.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Constructor.
+	 */
+	CountrySnapshot::CountrySnapshot():
+		mImage(NULL),
+		mImageSize(0),
+		mHeader(NULL),
+		mRecords(NULL),
+		mStrings(NULL)
+	{
+	}
+
+	/**
+	 * Destructor.
+	 */
+	CountrySnapshot::~CountrySnapshot()
+	{
+		this->unload();
+	}
+
+	/**
+	 * Write a snapshot image to a file.
+	 * @param filePath Path of the file to write.
+	 * @param countries Countries to write, in CountryTable order.
+	 * @param checksum Value saved in the header. Used to check if the
+	 * image was created from the current data files.
+	 * @return true if the image was written, false otherwise.
+	 */
+	bool CountrySnapshot::write(
+		const MAUtil::String& filePath,
+		const MAUtil::Vector<Country*>& countries,
+		const int checksum)
+	{
+		// Compute the size of the strings area.
+		int countCountries = countries.size();
+		int stringsSize = 0;
+		for (int index = 0; index < countCountries; index++)
+		{
+			for (int field = 0; field < SnapshotStoredFieldCount; field++)
+			{
+				stringsSize += getCountryField(
+					*countries[index], (SnapshotField) field).length + 1;
+			}
+		}
+
+		// Allocate the image.
+		int recordsOffset = sizeof(SnapshotHeader);
+		int stringsOffset = recordsOffset +
+			countCountries * sizeof(SnapshotRecord);
+		int imageSize = stringsOffset + stringsSize;
+		char* image = (char*) malloc(imageSize);
+		if (!image)
+		{
+			return false;
+		}
+
+		SnapshotHeader* header = (SnapshotHeader*) image;
+		header->magic = SNAPSHOT_MAGIC;
+		header->version = SNAPSHOT_VERSION;
+		header->checksum = checksum;
+		header->countCountries = countCountries;
+		header->recordsOffset = recordsOffset;
+		header->stringsOffset = stringsOffset;
+		header->stringsSize = stringsSize;
+
+		// Fill records and strings.
+		SnapshotRecord* records = (SnapshotRecord*) (image + recordsOffset);
+		char* strings = image + stringsOffset;
+		int stringsEnd = 0;
+		for (int index = 0; index < countCountries; index++)
+		{
+			Country* country = countries[index];
+			SnapshotRecord& record = records[index];
+			record.flagID = country->getFlagID();
+			for (int field = 0; field < SnapshotStoredFieldCount; field++)
+			{
+				StringSlice text = getCountryField(
+					*country, (SnapshotField) field);
+				record.textOffset[field] = stringsEnd;
+				record.textLength[field] = text.length;
+				memcpy(strings + stringsEnd, text.text, text.length + 1);
+				stringsEnd += text.length + 1;
+			}
+		}
+
+		bool result = writeBinaryFile(filePath, image, imageSize);
+		free(image);
+		return result;
+	}
+
+	/**
+	 * Load a snapshot image from a file.
+	 * The previously loaded image is released.
+	 * @param filePath Path of the file to read.
+	 * @return true if the image was read and it is valid, false otherwise.
+	 */
+	bool CountrySnapshot::load(const MAUtil::String& filePath)
+	{
+		this->unload();
+
+		mImage = readBinaryFile(filePath, mImageSize);
+		if (!mImage)
+		{
+			return false;
+		}
+
+		if (!this->validate())
+		{
+			printf("Invalid snapshot %s", filePath.c_str());
+			this->unload();
+			return false;
+		}
+
+		mHeader = (const SnapshotHeader*) mImage;
+		mRecords = (const SnapshotRecord*) (mImage + mHeader->recordsOffset);
+		mStrings = mImage + mHeader->stringsOffset;
+		return true;
+	}
+
+	/**
+	 * Release the loaded image.
+	 */
+	void CountrySnapshot::unload()
+	{
+		free(mImage);
+		mImage = NULL;
+		mImageSize = 0;
+		mHeader = NULL;
+		mRecords = NULL;
+		mStrings = NULL;
+	}
+
+	/**
+	 * Pass the ownership of the loaded image to the caller.
+	 * The snapshot is unloaded, but texts from the image stay valid until
+	 * the caller releases the image with free().
+	 * @return The image, or NULL if no image is loaded.
+	 */
+	char* CountrySnapshot::releaseImage()
+	{
+		char* image = mImage;
+		mImage = NULL;
+		this->unload();
+		return image;
+	}
+
+	/**
+	 * Check if an image is loaded.
+	 * @return true if an image is loaded, false otherwise.
+	 */
+	bool CountrySnapshot::isLoaded() const
+	{
+		return mHeader != NULL;
+	}
+
+	/**
+	 * Get the size of the loaded image.
+	 * @return Image size in bytes.
+	 */
+	int CountrySnapshot::getImageSize() const
+	{
+		return mImageSize;
+	}
+
+	/**
+	 * Get the checksum saved in the image header.
+	 * @return Checksum value.
+	 */
+	int CountrySnapshot::getChecksum() const
+	{
+		return mHeader ? mHeader->checksum : 0;
+	}
+
+	/**
+	 * Get the number of countries stored in image.
+	 * @return Number of countries.
+	 */
+	int CountrySnapshot::countCountries() const
+	{
+		return mHeader ? mHeader->countCountries : 0;
+	}
+
+	/**
+	 * Get the flag id for a given country.
+	 * @param index Country index. Must be >=0 and < countCountries().
+	 * @return Flag id.
+	 */
+	int CountrySnapshot::getFlagID(const int index) const
+	{
+		return mRecords[index].flagID;
+	}
+
+	/**
+	 * Get a text field for a given country.
+	 * @param index Country index. Must be >=0 and < countCountries().
+	 * @param field Field to get.
+	 * @param outLength Will contain the text length.
+	 * @return Null terminated text. It points inside the image and
+	 * it is valid until the image is released.
+	 */
+	const char* CountrySnapshot::getText(
+		const int index,
+		const SnapshotField field,
+		int& outLength) const
+	{
+		const SnapshotRecord& record = mRecords[index];
+		outLength = record.textLength[field];
+		return mStrings + record.textOffset[field];
+	}
+
+	/**
+	 * Set summary fields of a country with values from the image.
+	 * Texts point inside the image, so the image must be valid
+	 * while the country exists(see releaseImage()).
+	 * @param index Country index. Must be >=0 and < countCountries().
+	 * @param country Country to fill.
+	 */
+	void CountrySnapshot::fillCountry(
+		const int index,
+		Country& country) const
+	{
+		// Summary texts are not copied.
+		StringSlice slice;
+		country.setFlagID(this->getFlagID(index));
+		slice.text = this->getText(index, SnapshotFieldFileName, slice.length);
+		country.setFileName(slice);
+		slice.text = this->getText(index, SnapshotFieldName, slice.length);
+		country.setName(slice);
+		slice.text = this->getText(index, SnapshotFieldPopulation, slice.length);
+		country.setPopulation(slice);
+		slice.text = this->getText(index, SnapshotFieldArea, slice.length);
+		country.setArea(slice);
+		slice.text = this->getText(index, SnapshotFieldCapital, slice.length);
+		country.setCapital(slice);
+	}
+
+	/**
+	 * Check if the header and all records of the loaded image are valid.
+	 * @return true if the image is valid, false otherwise.
+	 */
+	bool CountrySnapshot::validate() const
+	{
+		if (mImageSize < (int) sizeof(SnapshotHeader))
+		{
+			return false;
+		}
+
+		const SnapshotHeader* header = (const SnapshotHeader*) mImage;
+		if (header->magic != SNAPSHOT_MAGIC ||
+			header->version != SNAPSHOT_VERSION ||
+			header->countCountries < 0 ||
+			header->recordsOffset != (int) sizeof(SnapshotHeader) ||
+			header->stringsOffset != header->recordsOffset +
+				header->countCountries * (int) sizeof(SnapshotRecord) ||
+			header->stringsSize < 0 ||
+			header->stringsOffset + header->stringsSize != mImageSize)
+		{
+			return false;
+		}
+
+		// Each text must be inside the strings area and null terminated.
+		const SnapshotRecord* records =
+			(const SnapshotRecord*) (mImage + header->recordsOffset);
+		const char* strings = mImage + header->stringsOffset;
+		for (int index = 0; index < header->countCountries; index++)
+		{
+			for (int field = 0; field < SnapshotStoredFieldCount; field++)
+			{
+				int offset = records[index].textOffset[field];
+				int length = records[index].textLength[field];
+				if (offset < 0 || length < 0 ||
+					offset + length >= header->stringsSize ||
+					strings[offset + length] != '\0')
+				{
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * Get the value of a given field from a country.
+	 * @param country Country to read.
+	 * @param field Field to get.
+	 * @return Field value.
+	 */
+	StringSlice CountrySnapshot::getCountryField(
+		const Country& country,
+		const SnapshotField field)
+	{
+		switch (field)
+		{
+		case SnapshotFieldFileName:
+			return country.getFileNameSlice();
+		case SnapshotFieldName:
+			return country.getNameSlice();
+		case SnapshotFieldPopulation:
+			return country.getPopulationSlice();
+		case SnapshotFieldArea:
+			return country.getAreaSlice();
+		case SnapshotFieldCapital:
+			return country.getCapitalSlice();
+		default:
+			return StringArena::emptySlice();
+		}
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,238 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountrySnapshot.h
+ * @author Bogdan Iusco
+ *
+ * @brief Binary image that contains all country data.
+ */
+
+#ifndef EC_COUNTRY_SNAPSHOT_H_
+#define EC_COUNTRY_SNAPSHOT_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+#include "Country.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Text fields of a country.
+	 * Only summary fields(the ones before SnapshotFieldLanguages) are
+	 * stored in the image.
+	 */
+	enum SnapshotField
+	{
+		SnapshotFieldFileName = 0,
+		SnapshotFieldName,
+		SnapshotFieldPopulation,
+		SnapshotFieldArea,
+		SnapshotFieldCapital,
+		SnapshotFieldLanguages,
+		SnapshotFieldGovernment,
+		SnapshotFieldCount,
+		SnapshotStoredFieldCount = SnapshotFieldLanguages
+	};
+
+	/**
+	 * First bytes of a snapshot image.
+	 * All offsets are relative to the beginning of the image.
+	 */
+	struct SnapshotHeader
+	{
+		int magic;
+		int version;
+		int checksum;
+		int countCountries;
+		int recordsOffset;
+		int stringsOffset;
+		int stringsSize;
+	};
+
+	/**
+	 * Fixed size record stored for each country.
+	 * Text offsets are relative to the beginning of the strings area.
+	 * Each text is followed by a null character that is not counted in
+	 * its length.
+	 */
+	struct SnapshotRecord
+	{
+		int flagID;
+		int textOffset[SnapshotStoredFieldCount];
+		int textLength[SnapshotStoredFieldCount];
+	};
+
+	/**
+	 * @brief Binary image with the summary data of all countries.
+	 * The image has a header, a table of fixed size records (one for each
+	 * country, in CountryTable order) and an area with all texts encoded
+	 * as UTF-8. It is read with a single read operation and needs no parsing.
+	 */
+	class CountrySnapshot
+	{
+	public:
+		/**
+		 * Constructor.
+		 */
+		CountrySnapshot();
+
+		/**
+		 * Destructor.
+		 */
+		~CountrySnapshot();
+
+		/**
+		 * Write a snapshot image to a file.
+		 * @param filePath Path of the file to write.
+		 * @param countries Countries to write, in CountryTable order.
+		 * @param checksum Value saved in the header. Used to check if the
+		 * image was created from the current data files.
+		 * @return true if the image was written, false otherwise.
+		 */
+		static bool write(
+			const MAUtil::String& filePath,
+			const MAUtil::Vector<Country*>& countries,
+			const int checksum);
+
+		/**
+		 * Load a snapshot image from a file.
+		 * The previously loaded image is released.
+		 * @param filePath Path of the file to read.
+		 * @return true if the image was read and it is valid, false otherwise.
+		 */
+		bool load(const MAUtil::String& filePath);
+
+		/**
+		 * Release the loaded image.
+		 */
+		void unload();
+
+		/**
+		 * Pass the ownership of the loaded image to the caller.
+		 * The snapshot is unloaded, but texts from the image stay valid until
+		 * the caller releases the image with free().
+		 * @return The image, or NULL if no image is loaded.
+		 */
+		char* releaseImage();
+
+		/**
+		 * Check if an image is loaded.
+		 * @return true if an image is loaded, false otherwise.
+		 */
+		bool isLoaded() const;
+
+		/**
+		 * Get the size of the loaded image.
+		 * @return Image size in bytes.
+		 */
+		int getImageSize() const;
+
+		/**
+		 * Get the checksum saved in the image header.
+		 * @return Checksum value.
+		 */
+		int getChecksum() const;
+
+		/**
+		 * Get the number of countries stored in image.
+		 * @return Number of countries.
+		 */
+		int countCountries() const;
+
+		/**
+		 * Get the flag id for a given country.
+		 * @param index Country index. Must be >=0 and < countCountries().
+		 * @return Flag id.
+		 */
+		int getFlagID(const int index) const;
+
+		/**
+		 * Get a text field for a given country.
+		 * @param index Country index. Must be >=0 and < countCountries().
+		 * @param field Field to get.
+		 * @param outLength Will contain the text length.
+		 * @return Null terminated text. It points inside the image and
+		 * it is valid until the image is released.
+		 */
+		const char* getText(
+			const int index,
+			const SnapshotField field,
+			int& outLength) const;
+
+		/**
+		 * Set summary fields of a country with values from the image.
+		 * Texts point inside the image, so the image must be valid
+		 * while the country exists(see releaseImage()).
+		 * @param index Country index. Must be >=0 and < countCountries().
+		 * @param country Country to fill.
+		 */
+		void fillCountry(
+			const int index,
+			Country& country) const;
+
+	private:
+		/**
+		 * Check if the header and all records of the loaded image are valid.
+		 * @return true if the image is valid, false otherwise.
+		 */
+		bool validate() const;
+
+		/**
+		 * Get the value of a given field from a country.
+		 * @param country Country to read.
+		 * @param field Field to get.
+		 * @return Field value.
+		 */
+		static StringSlice getCountryField(
+			const Country& country,
+			const SnapshotField field);
+
+	private:
+		/**
+		 * Image data.
+		 */
+		char* mImage;
+
+		/**
+		 * Image size in bytes.
+		 */
+		int mImageSize;
+
+		/**
+		 * Points to the image header.
+		 */
+		const SnapshotHeader* mHeader;
+
+		/**
+		 * Points to the first record.
+		 */
+		const SnapshotRecord* mRecords;
+
+		/**
+		 * Points to the strings area.
+		 */
+		const char* mStrings;
+
+	}; // end of CountrySnapshot
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_SNAPSHOT_H_ */
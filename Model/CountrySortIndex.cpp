@@ -0,0 +1,192 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountrySortIndex.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Sorted orders of the countries stored in the database.
+ */
+
+#include <mastdlib.h>
+
+#include "CountrySortIndex.h"
+#include "CountrySummaryTable.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Constructor.
+	 * @param summaryTable Table that contains the values to sort.
+	 */
+	CountrySortIndex::CountrySortIndex(const CountrySummaryTable& summaryTable):
+		mSummaryTable(summaryTable),
+		mNextVersion(0)
+	{
+		this->invalidate();
+	}
+
+	/**
+	 * Get the country ids sorted by a given field.
+	 * Countries with equal values keep their id order.
+	 * @param field Field used to sort.
+	 * @param ascending If true the smallest value comes first.
+	 * @return Sorted country ids. The array is valid until the next
+	 * call to invalidate().
+	 */
+	const MAUtil::Vector<int>& CountrySortIndex::getSortedIDs(
+		const CountrySortField field,
+		const bool ascending)
+	{
+		int direction = ascending ? 0 : 1;
+		MAUtil::Vector<int>& sortedIDs = mSortedIDs[field][direction];
+
+		// Rows may have been added since the permutation was built.
+		if (!mIsBuilt[field][direction] ||
+			sortedIDs.size() != mSummaryTable.countRows())
+		{
+			this->build(field, ascending, sortedIDs);
+			mIsBuilt[field][direction] = true;
+			mVersions[field][direction] = mNextVersion++;
+		}
+		return sortedIDs;
+	}
+
+	/**
+	 * Get the version of a permutation returned by getSortedIDs().
+	 * @param ids Array to check.
+	 * @return A number that is different each time a permutation is
+	 * built, or -1 if the array is not a built permutation of this
+	 * index.
+	 */
+	int CountrySortIndex::getVersion(const MAUtil::Vector<int>& ids) const
+	{
+		for (int field = 0; field < CountrySortFieldCount; field++)
+		{
+			for (int direction = 0; direction < 2; direction++)
+			{
+				if (&ids == &mSortedIDs[field][direction] &&
+					mIsBuilt[field][direction])
+				{
+					return mVersions[field][direction];
+				}
+			}
+		}
+		return -1;
+	}
+
+	/**
+	 * Remove all permutations. Must be called when the data changes.
+	 */
+	void CountrySortIndex::invalidate()
+	{
+		for (int field = 0; field < CountrySortFieldCount; field++)
+		{
+			for (int direction = 0; direction < 2; direction++)
+			{
+				mSortedIDs[field][direction].clear();
+				mIsBuilt[field][direction] = false;
+				mVersions[field][direction] = -1;
+			}
+		}
+	}
+
+	/**
+	 * Compares two countries for mergeSort().
+	 */
+	struct CountrySortCompare
+	{
+		const CountrySortIndex* index;
+		CountrySortField field;
+		bool ascending;
+
+		int operator()(const int firstID, const int secondID) const
+		{
+			int result = index->compare(field, firstID, secondID);
+			return ascending ? result : -result;
+		}
+	};
+
+	/**
+	 * Sort all country ids by a given field.
+	 * @param field Field used to sort.
+	 * @param ascending If true the smallest value comes first.
+	 * @param outIDs Will contain the sorted ids.
+	 */
+	void CountrySortIndex::build(
+		const CountrySortField field,
+		const bool ascending,
+		MAUtil::Vector<int>& outIDs)
+	{
+		int countIDs = mSummaryTable.countRows();
+		outIDs.clear();
+		outIDs.reserve(countIDs);
+		for (int id = 0; id < countIDs; id++)
+		{
+			outIDs.add(id);
+		}
+		if (countIDs < 2)
+		{
+			return;
+		}
+
+		CountrySortCompare compare = { this, field, ascending };
+		mergeSort(&outIDs[0], countIDs, compare);
+	}
+
+	/**
+	 * Compare the values of two countries.
+	 * @param field Field to compare.
+	 * @param firstID Id of the first country.
+	 * @param secondID Id of the second country.
+	 * @return A negative value if the first value is smaller, zero if
+	 * values are equal and a positive value otherwise.
+	 */
+	int CountrySortIndex::compare(
+		const CountrySortField field,
+		const int firstID,
+		const int secondID) const
+	{
+		switch (field)
+		{
+		case CountrySortByName:
+			return strcmp(mSummaryTable.getName(firstID).text,
+				mSummaryTable.getName(secondID).text);
+		case CountrySortByCapital:
+			return strcmp(mSummaryTable.getCapital(firstID).text,
+				mSummaryTable.getCapital(secondID).text);
+		case CountrySortByPopulation:
+		{
+			double first = mSummaryTable.getPopulation(firstID);
+			double second = mSummaryTable.getPopulation(secondID);
+			return first < second ? -1 : (first > second ? 1 : 0);
+		}
+		case CountrySortByArea:
+		{
+			double first = mSummaryTable.getArea(firstID);
+			double second = mSummaryTable.getArea(secondID);
+			return first < second ? -1 : (first > second ? 1 : 0);
+		}
+		default:
+			return 0;
+		}
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,149 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountrySortIndex.h
+ * @author Bogdan Iusco
+ *
+ * @brief Sorted orders of the countries stored in the database.
+ */
+
+#ifndef EC_COUNTRY_SORT_INDEX_H_
+#define EC_COUNTRY_SORT_INDEX_H_
+
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	// Forward declarations for EuropeanCountries namespace classes.
+	class CountrySummaryTable;
+
+	/**
+	 * Fields that can be used to sort the countries.
+	 */
+	enum CountrySortField
+	{
+		CountrySortByName = 0,
+		CountrySortByCapital,
+		CountrySortByPopulation,
+		CountrySortByArea,
+		CountrySortFieldCount
+	};
+
+	/**
+	 * @brief Builds and caches permutations of the country ids sorted by a
+	 * given field. A permutation is built the first time it is requested
+	 * and it is reused until the data changes.
+	 */
+	class CountrySortIndex
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param summaryTable Table that contains the values to sort.
+		 */
+		CountrySortIndex(const CountrySummaryTable& summaryTable);
+
+		/**
+		 * Get the country ids sorted by a given field.
+		 * Countries with equal values keep their id order.
+		 * @param field Field used to sort.
+		 * @param ascending If true the smallest value comes first.
+		 * @return Sorted country ids. The array is valid until the next
+		 * call to invalidate().
+		 */
+		const MAUtil::Vector<int>& getSortedIDs(
+			const CountrySortField field,
+			const bool ascending);
+
+		/**
+		 * Get the version of a permutation returned by getSortedIDs().
+		 * @param ids Array to check.
+		 * @return A number that is different each time a permutation is
+		 * built, or -1 if the array is not a built permutation of this
+		 * index.
+		 */
+		int getVersion(const MAUtil::Vector<int>& ids) const;
+
+		/**
+		 * Remove all permutations. Must be called when the data changes.
+		 */
+		void invalidate();
+
+	private:
+		/**
+		 * Used by build() to compare countries.
+		 */
+		friend struct CountrySortCompare;
+
+		/**
+		 * Sort all country ids by a given field.
+		 * @param field Field used to sort.
+		 * @param ascending If true the smallest value comes first.
+		 * @param outIDs Will contain the sorted ids.
+		 */
+		void build(
+			const CountrySortField field,
+			const bool ascending,
+			MAUtil::Vector<int>& outIDs);
+
+		/**
+		 * Compare the values of two countries.
+		 * @param field Field to compare.
+		 * @param firstID Id of the first country.
+		 * @param secondID Id of the second country.
+		 * @return A negative value if the first value is smaller, zero if
+		 * values are equal and a positive value otherwise.
+		 */
+		int compare(
+			const CountrySortField field,
+			const int firstID,
+			const int secondID) const;
+
+	private:
+		/**
+		 * Table that contains the values to sort.
+		 */
+		const CountrySummaryTable& mSummaryTable;
+
+		/**
+		 * Sorted ids for each field, in ascending and descending order.
+		 */
+		MAUtil::Vector<int> mSortedIDs[CountrySortFieldCount][2];
+
+		/**
+		 * True for the permutations that are built.
+		 */
+		bool mIsBuilt[CountrySortFieldCount][2];
+
+		/**
+		 * Version of each built permutation.
+		 */
+		int mVersions[CountrySortFieldCount][2];
+
+		/**
+		 * Version given to the next built permutation.
+		 */
+		int mNextVersion;
+
+	}; // end of CountrySortIndex
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_SORT_INDEX_H_ */
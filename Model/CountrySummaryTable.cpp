@@ -0,0 +1,274 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountrySummaryTable.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Columns with the country fields used by the countries list.
+ */
+
+#include <mastdlib.h>
+
+#include "Country.h"
+#include "CountrySummaryTable.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Unit that can follow an area value.
+	 */
+	struct AreaUnit
+	{
+		const char* name;
+		double squareKilometers;
+	};
+
+	/**
+	 * Known area units. Some data files use "km" for square kilometers.
+	 */
+	static const AreaUnit sAreaUnits[] =
+	{
+		{ "", 1 },
+		{ "sq km", 1 },
+		{ "km", 1 },
+		{ "km2", 1 },
+		{ "sq mi", 2.589988 }
+	};
+
+	/**
+	 * Parse a population text, such as "81,799,600".
+	 * @param text Text to parse.
+	 * @return Population, or -1 if the text is not a number.
+	 */
+	static double parsePopulation(const StringSlice& text)
+	{
+		double value = 0;
+		int position = parseNumber(text.text, text.length, value);
+		while (position > 0 &&
+			position < text.length && text.text[position] == ' ')
+		{
+			position++;
+		}
+		if (position == 0 || position != text.length)
+		{
+			return -1;
+		}
+		return value;
+	}
+
+	/**
+	 * Parse an area text, such as "357,021 sq km".
+	 * @param text Text to parse.
+	 * @return Area in square kilometers, or -1 if the text is not a number
+	 * with a known unit.
+	 */
+	static double parseArea(const StringSlice& text)
+	{
+		double value = 0;
+		int position = parseNumber(text.text, text.length, value);
+		if (position == 0)
+		{
+			return -1;
+		}
+
+		// Compare the rest of the text with the known units.
+		int end = text.length;
+		while (position < end && text.text[position] == ' ')
+		{
+			position++;
+		}
+		while (end > position && text.text[end - 1] == ' ')
+		{
+			end--;
+		}
+		const char* unit = text.text + position;
+		int unitLength = end - position;
+		int countUnits = sizeof(sAreaUnits) / sizeof(sAreaUnits[0]);
+		for (int index = 0; index < countUnits; index++)
+		{
+			const char* name = sAreaUnits[index].name;
+			if ((int) strlen(name) == unitLength &&
+				memcmp(name, unit, unitLength) == 0)
+			{
+				return value * sAreaUnits[index].squareKilometers;
+			}
+		}
+		return -1;
+	}
+
+	/**
+	 * Constructor.
+	 */
+	CountrySummaryTable::CountrySummaryTable():
+		mTotalPopulation(0),
+		mTotalArea(0)
+	{
+	}
+
+	/**
+	 * Add a row for a given country.
+	 * Countries must be added in id order.
+	 * @param country Country to add. Its texts must be valid while
+	 * the row exists.
+	 */
+	void CountrySummaryTable::addRow(const Country& country)
+	{
+		StringSlice name = country.getNameSlice();
+		mFlagIDs.add(country.getFlagID());
+		mNames.add(name);
+		mFirstLetters.add(name.length > 0 ? name.text[0] : '\0');
+		mCapitals.add(country.getCapitalSlice());
+
+		double population = parsePopulation(country.getPopulationSlice());
+		mPopulations.add(population);
+		if (population > 0)
+		{
+			mTotalPopulation += population;
+		}
+
+		double area = parseArea(country.getAreaSlice());
+		mAreas.add(area);
+		if (area > 0)
+		{
+			mTotalArea += area;
+		}
+	}
+
+	/**
+	 * Reserve space for a given number of rows.
+	 * @param countRows Number of rows.
+	 */
+	void CountrySummaryTable::reserve(const int countRows)
+	{
+		mFlagIDs.reserve(countRows);
+		mNames.reserve(countRows);
+		mFirstLetters.reserve(countRows);
+		mCapitals.reserve(countRows);
+		mPopulations.reserve(countRows);
+		mAreas.reserve(countRows);
+	}
+
+	/**
+	 * Remove all rows.
+	 */
+	void CountrySummaryTable::clear()
+	{
+		mFlagIDs.clear();
+		mNames.clear();
+		mFirstLetters.clear();
+		mCapitals.clear();
+		mPopulations.clear();
+		mAreas.clear();
+		mTotalPopulation = 0;
+		mTotalArea = 0;
+	}
+
+	/**
+	 * Get the number of rows.
+	 * @return Number of rows.
+	 */
+	int CountrySummaryTable::countRows() const
+	{
+		return mFlagIDs.size();
+	}
+
+	/**
+	 * Get the flag id of a country.
+	 * @param id Country id. Must be >=0 and < countRows().
+	 * @return Image handle to a resource file.
+	 */
+	int CountrySummaryTable::getFlagID(const int id) const
+	{
+		return mFlagIDs[id];
+	}
+
+	/**
+	 * Get the name of a country.
+	 * @param id Country id. Must be >=0 and < countRows().
+	 * @return Null terminated name and its length.
+	 */
+	const StringSlice& CountrySummaryTable::getName(const int id) const
+	{
+		return mNames[id];
+	}
+
+	/**
+	 * Get the first letter of a country name, used for list sections.
+	 * @param id Country id. Must be >=0 and < countRows().
+	 * @return First character of the name, or zero if the name is empty.
+	 */
+	char CountrySummaryTable::getFirstLetter(const int id) const
+	{
+		return mFirstLetters[id];
+	}
+
+	/**
+	 * Get the capital of a country.
+	 * @param id Country id. Must be >=0 and < countRows().
+	 * @return Null terminated capital name and its length.
+	 */
+	const StringSlice& CountrySummaryTable::getCapital(const int id) const
+	{
+		return mCapitals[id];
+	}
+
+	/**
+	 * Get the population of a country, parsed from its text when the
+	 * row was added.
+	 * @param id Country id. Must be >=0 and < countRows().
+	 * @return Population, or a negative value if the text is not a number.
+	 */
+	double CountrySummaryTable::getPopulation(const int id) const
+	{
+		return mPopulations[id];
+	}
+
+	/**
+	 * Get the area of a country, parsed from its text when the
+	 * row was added.
+	 * @param id Country id. Must be >=0 and < countRows().
+	 * @return Area in square kilometers, or a negative value if the text
+	 * is not a number with a known unit.
+	 */
+	double CountrySummaryTable::getArea(const int id) const
+	{
+		return mAreas[id];
+	}
+
+	/**
+	 * Get the sum of all known populations.
+	 * @return Total population.
+	 */
+	double CountrySummaryTable::getTotalPopulation() const
+	{
+		return mTotalPopulation;
+	}
+
+	/**
+	 * Get the sum of all known areas.
+	 * @return Total area in square kilometers.
+	 */
+	double CountrySummaryTable::getTotalArea() const
+	{
+		return mTotalArea;
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,180 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountrySummaryTable.h
+ * @author Bogdan Iusco
+ *
+ * @brief Columns with the country fields used by the countries list.
+ */
+
+#ifndef EC_COUNTRY_SUMMARY_TABLE_H_
+#define EC_COUNTRY_SUMMARY_TABLE_H_
+
+#include <MAUtil/Vector.h>
+
+#include "StringArena.h"
+
+namespace EuropeanCountries
+{
+
+	// Forward declarations for EuropeanCountries namespace classes.
+	class Country;
+
+	/**
+	 * @brief Stores the fields needed to build, sort and filter the
+	 * countries list in separate contiguous columns.
+	 * The row of a country is its id. Other fields are read from the
+	 * Country objects only when a country is displayed.
+	 */
+	class CountrySummaryTable
+	{
+	public:
+		/**
+		 * Constructor.
+		 */
+		CountrySummaryTable();
+
+		/**
+		 * Add a row for a given country.
+		 * Countries must be added in id order.
+		 * @param country Country to add. Its texts must be valid while
+		 * the row exists.
+		 */
+		void addRow(const Country& country);
+
+		/**
+		 * Reserve space for a given number of rows.
+		 * @param countRows Number of rows.
+		 */
+		void reserve(const int countRows);
+
+		/**
+		 * Remove all rows.
+		 */
+		void clear();
+
+		/**
+		 * Get the number of rows.
+		 * @return Number of rows.
+		 */
+		int countRows() const;
+
+		/**
+		 * Get the flag id of a country.
+		 * @param id Country id. Must be >=0 and < countRows().
+		 * @return Image handle to a resource file.
+		 */
+		int getFlagID(const int id) const;
+
+		/**
+		 * Get the name of a country.
+		 * @param id Country id. Must be >=0 and < countRows().
+		 * @return Null terminated name and its length.
+		 */
+		const StringSlice& getName(const int id) const;
+
+		/**
+		 * Get the first letter of a country name, used for list sections.
+		 * @param id Country id. Must be >=0 and < countRows().
+		 * @return First character of the name, or zero if the name is empty.
+		 */
+		char getFirstLetter(const int id) const;
+
+		/**
+		 * Get the capital of a country.
+		 * @param id Country id. Must be >=0 and < countRows().
+		 * @return Null terminated capital name and its length.
+		 */
+		const StringSlice& getCapital(const int id) const;
+
+		/**
+		 * Get the population of a country, parsed from its text when the
+		 * row was added.
+		 * @param id Country id. Must be >=0 and < countRows().
+		 * @return Population, or a negative value if the text is not a number.
+		 */
+		double getPopulation(const int id) const;
+
+		/**
+		 * Get the area of a country, parsed from its text when the
+		 * row was added.
+		 * @param id Country id. Must be >=0 and < countRows().
+		 * @return Area in square kilometers, or a negative value if the text
+		 * is not a number with a known unit.
+		 */
+		double getArea(const int id) const;
+
+		/**
+		 * Get the sum of all known populations.
+		 * @return Total population.
+		 */
+		double getTotalPopulation() const;
+
+		/**
+		 * Get the sum of all known areas.
+		 * @return Total area in square kilometers.
+		 */
+		double getTotalArea() const;
+
+	private:
+		/**
+		 * Flag id column.
+		 */
+		MAUtil::Vector<int> mFlagIDs;
+
+		/**
+		 * Name column. Texts are stored in the database string arena.
+		 */
+		MAUtil::Vector<StringSlice> mNames;
+
+		/**
+		 * First letter column.
+		 */
+		MAUtil::Vector<char> mFirstLetters;
+
+		/**
+		 * Capital column. Texts are stored in the database string arena.
+		 */
+		MAUtil::Vector<StringSlice> mCapitals;
+
+		/**
+		 * Population column.
+		 */
+		MAUtil::Vector<double> mPopulations;
+
+		/**
+		 * Area column, in square kilometers.
+		 */
+		MAUtil::Vector<double> mAreas;
+
+		/**
+		 * Sum of all known populations.
+		 */
+		double mTotalPopulation;
+
+		/**
+		 * Sum of all known areas.
+		 */
+		double mTotalArea;
+
+	}; // end of CountrySummaryTable
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_SUMMARY_TABLE_H_ */
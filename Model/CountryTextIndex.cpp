@@ -0,0 +1,647 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryTextIndex.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Full text search over the languages and government texts.
+ */
+
+// Longer words are truncated, both when indexing and when searching.
+#define MAX_WORD_LENGTH 32
+
+// BM25 parameters.
+#define BM25_K1 1.2
+#define BM25_B 0.75
+
+#include <madmath.h>
+#include <mastdlib.h>
+
+#include "CountryTextIndex.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Check if a byte is part of a word.
+	 * Bytes of UTF-8 sequences are part of words, so accented letters
+	 * do not split words.
+	 * @param c Byte to check.
+	 * @return true if the byte is part of a word, false otherwise.
+	 */
+	static inline bool isWordByte(const unsigned char c)
+	{
+		return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+			(c >= '0' && c <= '9') || c >= 0x80;
+	}
+
+	/**
+	 * Find the next word or double quote character of a text.
+	 * @param text Text to split.
+	 * @param length Text length.
+	 * @param position Position where the search starts. Will be set after
+	 * the found word or quote.
+	 * @param outWord Will contain the lower case word. Must have room for
+	 * MAX_WORD_LENGTH characters.
+	 * @param outLength Will contain the word length, zero for a quote.
+	 * @param outQuote Will be set to true if a double quote character was
+	 * found, false otherwise.
+	 * @return true if a word or a quote was found, false if the text ended.
+	 */
+	static bool nextWord(
+		const char* text,
+		const int length,
+		int& position,
+		char* outWord,
+		int& outLength,
+		bool& outQuote)
+	{
+		outQuote = false;
+		outLength = 0;
+		while (position < length && !isWordByte(text[position]))
+		{
+			if (text[position++] == '"')
+			{
+				outQuote = true;
+				return true;
+			}
+		}
+
+		while (position < length && isWordByte(text[position]))
+		{
+			char c = text[position++];
+			if (outLength < MAX_WORD_LENGTH)
+			{
+				outWord[outLength++] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+			}
+		}
+		return outLength > 0;
+	}
+
+	/**
+	 * Append a value encoded on 7 bits per byte. The last byte of the value
+	 * has the highest bit cleared.
+	 * @param buffer Buffer to write.
+	 * @param value Value to write. Must be >= 0.
+	 */
+	static void writeVarint(MAUtil::Vector<unsigned char>& buffer, int value)
+	{
+		while (value >= 0x80)
+		{
+			buffer.add((unsigned char) ((value & 0x7F) | 0x80));
+			value >>= 7;
+		}
+		buffer.add((unsigned char) value);
+	}
+
+	/**
+	 * Read a value written by writeVarint().
+	 * @param data Position of the value. Will be set after the value.
+	 * @return The value.
+	 */
+	static inline int readVarint(const unsigned char*& data)
+	{
+		int value = 0;
+		int shift = 0;
+		while (*data & 0x80)
+		{
+			value |= (*data++ & 0x7F) << shift;
+			shift += 7;
+		}
+		value |= *data++ << shift;
+		return value;
+	}
+
+	/**
+	 * Compare two byte strings.
+	 * @return A negative value, zero or a positive value if the first string
+	 * is smaller, equal or bigger than the second one.
+	 */
+	static int compareWords(
+		const char* first,
+		const int firstLength,
+		const char* second,
+		const int secondLength)
+	{
+		int length = firstLength < secondLength ? firstLength : secondLength;
+		int result = memcmp(first, second, length);
+		return result != 0 ? result : firstLength - secondLength;
+	}
+
+	/**
+	 * Compares two occurrences by their words for mergeSort().
+	 * The sort is stable, so occurrences of a word stay sorted by
+	 * country and position.
+	 */
+	struct OccurrenceCompare
+	{
+		int operator()(
+			const CountryTextIndex::Occurrence& first,
+			const CountryTextIndex::Occurrence& second) const
+		{
+			return compareWords(first.word.text, first.word.length,
+				second.word.text, second.word.length);
+		}
+	};
+
+	/**
+	 * Compares two matches for mergeSort(). Bigger scores go first.
+	 */
+	struct TextMatchCompare
+	{
+		int operator()(
+			const CountryTextMatch& first,
+			const CountryTextMatch& second) const
+		{
+			if (first.score == second.score)
+			{
+				return 0;
+			}
+			return first.score > second.score ? -1 : 1;
+		}
+	};
+
+	/**
+	 * Constructor.
+	 */
+	CountryTextIndex::CountryTextIndex():
+		mCountCountries(0),
+		mIsBuilt(false),
+		mAverageLength(0)
+	{
+	}
+
+	/**
+	 * Start building the index. The previous index is removed.
+	 * @param countCountries Number of countries. Country ids must be
+	 * in range 0..countCountries-1.
+	 */
+	void CountryTextIndex::beginBuild(const int countCountries)
+	{
+		this->clear();
+		mCountCountries = countCountries;
+		mCountryLengths.resize(countCountries);
+		mNextPositions.resize(countCountries);
+		for (int index = 0; index < countCountries; index++)
+		{
+			mCountryLengths[index] = 0;
+			mNextPositions[index] = 0;
+		}
+	}
+
+	/**
+	 * Add a text to a country.
+	 * Can be called several times for a country, e.g. once for each
+	 * field. A phrase cannot span two texts.
+	 * @param countryID Id of the country.
+	 * @param text Text to add. It does not need to be null terminated.
+	 * @param length Text length in bytes.
+	 */
+	void CountryTextIndex::addText(
+		const int countryID,
+		const char* text,
+		const int length)
+	{
+		if (countryID < 0 || countryID >= mCountCountries)
+		{
+			return;
+		}
+
+		// Leave a gap after the previous text, so that no phrase matches
+		// words from different texts.
+		int position = mNextPositions[countryID];
+		if (position > 0)
+		{
+			position++;
+		}
+
+		char word[MAX_WORD_LENGTH];
+		int wordLength = 0;
+		int textPosition = 0;
+		bool quote = false;
+		while (nextWord(text, length, textPosition, word, wordLength, quote))
+		{
+			if (quote)
+			{
+				continue;
+			}
+
+			Occurrence occurrence;
+			occurrence.word = mBuildArena.add(word, wordLength);
+			occurrence.countryID = countryID;
+			occurrence.position = position++;
+			mOccurrences.add(occurrence);
+			mCountryLengths[countryID]++;
+		}
+		mNextPositions[countryID] = position;
+	}
+
+	/**
+	 * Finish building the index. The index can be searched after
+	 * this call.
+	 */
+	void CountryTextIndex::endBuild()
+	{
+		int countOccurrences = mOccurrences.size();
+		if (countOccurrences > 0)
+		{
+			OccurrenceCompare compare;
+			mergeSort(&mOccurrences[0], countOccurrences, compare);
+		}
+
+		// Write a term and its posting list for each distinct word.
+		int index = 0;
+		while (index < countOccurrences)
+		{
+			const StringSlice& word = mOccurrences[index].word;
+			Term term;
+			term.textOffset = mTermTexts.size();
+			term.textLength = word.length;
+			term.postingsOffset = mPostings.size();
+			term.countCountries = 0;
+			mTermTexts.append(word.text, word.length);
+
+			int previousCountryID = 0;
+			while (index < countOccurrences &&
+				compareWords(word.text, word.length,
+					mOccurrences[index].word.text,
+					mOccurrences[index].word.length) == 0)
+			{
+				// Count the occurrences in this country.
+				int countryID = mOccurrences[index].countryID;
+				int end = index + 1;
+				while (end < countOccurrences &&
+					mOccurrences[end].countryID == countryID &&
+					mOccurrences[end].word.length == word.length &&
+					memcmp(mOccurrences[end].word.text, word.text,
+						word.length) == 0)
+				{
+					end++;
+				}
+
+				writeVarint(mPostings, countryID - previousCountryID);
+				writeVarint(mPostings, end - index);
+				int previousPosition = 0;
+				for (; index < end; index++)
+				{
+					int position = mOccurrences[index].position;
+					writeVarint(mPostings, position - previousPosition);
+					previousPosition = position;
+				}
+
+				previousCountryID = countryID;
+				term.countCountries++;
+			}
+			mTerms.add(term);
+		}
+
+		int totalLength = 0;
+		for (index = 0; index < mCountCountries; index++)
+		{
+			totalLength += mCountryLengths[index];
+		}
+		mAverageLength = mCountCountries > 0 ?
+			(double) totalLength / mCountCountries : 0;
+
+		// Words are not needed after the posting lists are written.
+		mOccurrences.clear();
+		mNextPositions.clear();
+		mBuildArena.clear();
+		mIsBuilt = true;
+	}
+
+	/**
+	 * Check if the index was built.
+	 * @return true if endBuild() was called since the last clear().
+	 */
+	bool CountryTextIndex::isBuilt() const
+	{
+		return mIsBuilt;
+	}
+
+	/**
+	 * Find the countries that match a given query.
+	 * @param query Words to search. Words between double quotes must
+	 * be found next to each other.
+	 * @param outMatches Will contain the found countries, the most
+	 * relevant first.
+	 */
+	void CountryTextIndex::search(
+		const MAUtil::String& query,
+		MAUtil::Vector<CountryTextMatch>& outMatches) const
+	{
+		outMatches.clear();
+		if (!mIsBuilt)
+		{
+			return;
+		}
+
+		// Split the query. Each distinct term is decoded once.
+		MAUtil::Vector<int> termIndexes;
+		MAUtil::Vector<int> queryTerms;
+		MAUtil::Vector<int> phraseStarts;
+		char word[MAX_WORD_LENGTH];
+		int wordLength = 0;
+		int position = 0;
+		bool quote = false;
+		bool inPhrase = false;
+		bool missingPhraseWord = false;
+		int phraseStart = 0;
+		while (nextWord(query.c_str(), query.length(), position, word,
+			wordLength, quote))
+		{
+			if (quote)
+			{
+				// A phrase starts or ends here.
+				if (inPhrase && queryTerms.size() - phraseStart > 1)
+				{
+					phraseStarts.add(phraseStart);
+					phraseStarts.add(queryTerms.size());
+				}
+				inPhrase = !inPhrase;
+				phraseStart = queryTerms.size();
+				continue;
+			}
+
+			int termIndex = this->findTerm(word, wordLength);
+			if (termIndex < 0)
+			{
+				// A phrase with an unknown word cannot match.
+				missingPhraseWord = missingPhraseWord || inPhrase;
+				continue;
+			}
+
+			int queryTerm = 0;
+			while (queryTerm < termIndexes.size() &&
+				termIndexes[queryTerm] != termIndex)
+			{
+				queryTerm++;
+			}
+			if (queryTerm == termIndexes.size())
+			{
+				termIndexes.add(termIndex);
+			}
+			queryTerms.add(queryTerm);
+		}
+		if (inPhrase && queryTerms.size() - phraseStart > 1)
+		{
+			phraseStarts.add(phraseStart);
+			phraseStarts.add(queryTerms.size());
+		}
+		if (termIndexes.size() == 0 || missingPhraseWord)
+		{
+			return;
+		}
+
+		// Sum the BM25 score of each term.
+		int countTerms = termIndexes.size();
+		TermPostings* postings = new TermPostings[countTerms];
+		MAUtil::Vector<double> scores;
+		MAUtil::Vector<bool> found;
+		scores.resize(mCountCountries);
+		found.resize(mCountCountries);
+		for (int countryID = 0; countryID < mCountCountries; countryID++)
+		{
+			scores[countryID] = 0;
+			found[countryID] = false;
+		}
+		for (int index = 0; index < countTerms; index++)
+		{
+			TermPostings& termPostings = postings[index];
+			this->decodePostings(termIndexes[index], termPostings);
+
+			double countCountries = termPostings.countryIDs.size();
+			double idf = log(1.0 +
+				(mCountCountries - countCountries + 0.5) / (countCountries + 0.5));
+			for (int entry = 0; entry < termPostings.countryIDs.size(); entry++)
+			{
+				int countryID = termPostings.countryIDs[entry];
+				double frequency = termPostings.positionStarts[entry + 1] -
+					termPostings.positionStarts[entry];
+				double lengthRatio = mAverageLength > 0 ?
+					mCountryLengths[countryID] / mAverageLength : 1;
+				scores[countryID] += idf * frequency * (BM25_K1 + 1) /
+					(frequency + BM25_K1 * (1 - BM25_B + BM25_B * lengthRatio));
+				found[countryID] = true;
+			}
+		}
+
+		// Countries must contain all phrases.
+		for (int index = 0; index < phraseStarts.size(); index += 2)
+		{
+			MAUtil::Vector<const TermPostings*> phrase;
+			for (int queryTerm = phraseStarts[index];
+				queryTerm < phraseStarts[index + 1]; queryTerm++)
+			{
+				phrase.add(&postings[queryTerms[queryTerm]]);
+			}
+			this->matchPhrase(phrase, found);
+		}
+		delete[] postings;
+
+		for (int countryID = 0; countryID < mCountCountries; countryID++)
+		{
+			if (found[countryID])
+			{
+				CountryTextMatch match;
+				match.countryID = countryID;
+				match.score = scores[countryID];
+				outMatches.add(match);
+			}
+		}
+		if (outMatches.size() > 0)
+		{
+			TextMatchCompare compare;
+			mergeSort(&outMatches[0], outMatches.size(), compare);
+		}
+	}
+
+	/**
+	 * Remove the index. Must be called when the data changes.
+	 */
+	void CountryTextIndex::clear()
+	{
+		mCountCountries = 0;
+		mIsBuilt = false;
+		mCountryLengths.clear();
+		mAverageLength = 0;
+		mTerms.clear();
+		mTermTexts = "";
+		mPostings.clear();
+		mOccurrences.clear();
+		mNextPositions.clear();
+		mBuildArena.clear();
+	}
+
+	/**
+	 * Get the memory used by the posting lists.
+	 * @return Size in bytes.
+	 */
+	int CountryTextIndex::getPostingsSize() const
+	{
+		return mPostings.size();
+	}
+
+	/**
+	 * Find a word in the dictionary.
+	 * @param word Lower case word.
+	 * @param length Word length.
+	 * @return Index of the term in mTerms, or -1 if it does not exist.
+	 */
+	int CountryTextIndex::findTerm(const char* word, const int length) const
+	{
+		int low = 0;
+		int high = mTerms.size();
+		while (low < high)
+		{
+			int middle = (low + high) / 2;
+			const Term& term = mTerms[middle];
+			int result = compareWords(mTermTexts.c_str() + term.textOffset,
+				term.textLength, word, length);
+			if (result == 0)
+			{
+				return middle;
+			}
+			if (result < 0)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		return -1;
+	}
+
+	/**
+	 * Decode the posting list of a term.
+	 * @param termIndex Index of the term in mTerms.
+	 * @param outPostings Will contain the decoded list.
+	 */
+	void CountryTextIndex::decodePostings(
+		const int termIndex,
+		TermPostings& outPostings) const
+	{
+		const Term& term = mTerms[termIndex];
+		const unsigned char* data = &mPostings[term.postingsOffset];
+		outPostings.countryIDs.reserve(term.countCountries);
+		outPostings.positionStarts.reserve(term.countCountries + 1);
+
+		int countryID = 0;
+		for (int entry = 0; entry < term.countCountries; entry++)
+		{
+			countryID += readVarint(data);
+			int frequency = readVarint(data);
+			outPostings.countryIDs.add(countryID);
+			outPostings.positionStarts.add(outPostings.positions.size());
+
+			int position = 0;
+			for (int index = 0; index < frequency; index++)
+			{
+				position += readVarint(data);
+				outPostings.positions.add(position);
+			}
+		}
+		outPostings.positionStarts.add(outPostings.positions.size());
+	}
+
+	/**
+	 * Find the countries that contain a phrase.
+	 * @param phrase Decoded posting lists of the phrase words, in
+	 * phrase order.
+	 * @param outFound Element i is set to false if country i does not
+	 * contain the phrase. Other elements are not changed.
+	 */
+	void CountryTextIndex::matchPhrase(
+		const MAUtil::Vector<const TermPostings*>& phrase,
+		MAUtil::Vector<bool>& outFound) const
+	{
+		// Only countries that contain the first word can match. Positions of
+		// the other words are searched in the same country.
+		const TermPostings& first = *phrase[0];
+		MAUtil::Vector<bool> matched;
+		matched.resize(mCountCountries);
+		for (int countryID = 0; countryID < mCountCountries; countryID++)
+		{
+			matched[countryID] = false;
+		}
+
+		MAUtil::Vector<int> entries;
+		entries.resize(phrase.size());
+		for (int entry = 0; entry < first.countryIDs.size(); entry++)
+		{
+			// Find the country in the lists of the other words.
+			int countryID = first.countryIDs[entry];
+			bool hasAllWords = true;
+			for (int word = 1; word < phrase.size() && hasAllWords; word++)
+			{
+				const MAUtil::Vector<int>& countryIDs = phrase[word]->countryIDs;
+				int low = 0;
+				int high = countryIDs.size();
+				while (low < high)
+				{
+					int middle = (low + high) / 2;
+					if (countryIDs[middle] < countryID)
+					{
+						low = middle + 1;
+					}
+					else
+					{
+						high = middle;
+					}
+				}
+				hasAllWords = low < countryIDs.size() && countryIDs[low] == countryID;
+				entries[word] = low;
+			}
+			if (!hasAllWords)
+			{
+				continue;
+			}
+
+			// Check each position of the first word.
+			for (int start = first.positionStarts[entry];
+				start < first.positionStarts[entry + 1] && !matched[countryID];
+				start++)
+			{
+				bool isPhrase = true;
+				for (int word = 1; word < phrase.size() && isPhrase; word++)
+				{
+					const TermPostings& postings = *phrase[word];
+					int expected = first.positions[start] + word;
+					isPhrase = false;
+					for (int index = postings.positionStarts[entries[word]];
+						index < postings.positionStarts[entries[word] + 1] &&
+						postings.positions[index] <= expected; index++)
+					{
+						isPhrase = postings.positions[index] == expected;
+					}
+				}
+				matched[countryID] = isPhrase;
+			}
+		}
+
+		for (int countryID = 0; countryID < mCountCountries; countryID++)
+		{
+			outFound[countryID] = outFound[countryID] && matched[countryID];
+		}
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,283 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryTextIndex.h
+ * @author Bogdan Iusco
+ *
+ * @brief Full text search over the languages and government texts.
+ */
+
+#ifndef EC_COUNTRY_TEXT_INDEX_H_
+#define EC_COUNTRY_TEXT_INDEX_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+#include "StringArena.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief A country found by a full text search.
+	 */
+	struct CountryTextMatch
+	{
+		/**
+		 * Id of the country.
+		 */
+		int countryID;
+
+		/**
+		 * Relevance of the country(BM25). Bigger is better.
+		 */
+		double score;
+	};
+
+	/**
+	 * @brief Inverted index over the long text fields of the countries.
+	 * Texts are split in words(ASCII letters are converted to lower case).
+	 * For each word the index keeps the countries that contain it and the
+	 * positions of the word, encoded as variable length deltas.
+	 *
+	 * A query is a list of words. Countries that contain any of them are
+	 * ranked with BM25. Words between double quotes form a phrase: only
+	 * the countries that contain the words next to each other are found.
+	 */
+	class CountryTextIndex
+	{
+	public:
+		/**
+		 * Constructor.
+		 */
+		CountryTextIndex();
+
+		/**
+		 * Start building the index. The previous index is removed.
+		 * @param countCountries Number of countries. Country ids must be
+		 * in range 0..countCountries-1.
+		 */
+		void beginBuild(const int countCountries);
+
+		/**
+		 * Add a text to a country.
+		 * Can be called several times for a country, e.g. once for each
+		 * field. A phrase cannot span two texts.
+		 * @param countryID Id of the country.
+		 * @param text Text to add. It does not need to be null terminated.
+		 * @param length Text length in bytes.
+		 */
+		void addText(const int countryID, const char* text, const int length);
+
+		/**
+		 * Finish building the index. The index can be searched after
+		 * this call.
+		 */
+		void endBuild();
+
+		/**
+		 * Check if the index was built.
+		 * @return true if endBuild() was called since the last clear().
+		 */
+		bool isBuilt() const;
+
+		/**
+		 * Find the countries that match a given query.
+		 * @param query Words to search. Words between double quotes must
+		 * be found next to each other.
+		 * @param outMatches Will contain the found countries, the most
+		 * relevant first.
+		 */
+		void search(
+			const MAUtil::String& query,
+			MAUtil::Vector<CountryTextMatch>& outMatches) const;
+
+		/**
+		 * Remove the index. Must be called when the data changes.
+		 */
+		void clear();
+
+		/**
+		 * Get the memory used by the posting lists.
+		 * @return Size in bytes.
+		 */
+		int getPostingsSize() const;
+
+	private:
+		/**
+		 * An occurrence of a word, used while building the index.
+		 */
+		struct Occurrence
+		{
+			/**
+			 * Lower case word. Stored in mBuildArena.
+			 */
+			StringSlice word;
+
+			/**
+			 * Id of the country.
+			 */
+			int countryID;
+
+			/**
+			 * Position of the word in the country texts.
+			 */
+			int position;
+		};
+
+		/**
+		 * A word from the dictionary.
+		 */
+		struct Term
+		{
+			/**
+			 * Offset of the word in mTermTexts.
+			 */
+			int textOffset;
+
+			/**
+			 * Word length in bytes.
+			 */
+			int textLength;
+
+			/**
+			 * Offset of the posting list in mPostings.
+			 */
+			int postingsOffset;
+
+			/**
+			 * Number of countries that contain the word.
+			 */
+			int countCountries;
+		};
+
+		/**
+		 * Decoded posting list of a term.
+		 */
+		struct TermPostings
+		{
+			/**
+			 * Countries that contain the term, ascending.
+			 */
+			MAUtil::Vector<int> countryIDs;
+
+			/**
+			 * Element i is the index in positions of the first position
+			 * of countryIDs[i]. Has an extra element at the end.
+			 */
+			MAUtil::Vector<int> positionStarts;
+
+			/**
+			 * Positions of the term, ascending for each country.
+			 */
+			MAUtil::Vector<int> positions;
+		};
+
+		/**
+		 * Used by endBuild() to compare occurrences.
+		 */
+		friend struct OccurrenceCompare;
+
+		/**
+		 * Find a word in the dictionary.
+		 * @param word Lower case word.
+		 * @param length Word length.
+		 * @return Index of the term in mTerms, or -1 if it does not exist.
+		 */
+		int findTerm(const char* word, const int length) const;
+
+		/**
+		 * Decode the posting list of a term.
+		 * @param termIndex Index of the term in mTerms.
+		 * @param outPostings Will contain the decoded list.
+		 */
+		void decodePostings(
+			const int termIndex,
+			TermPostings& outPostings) const;
+
+		/**
+		 * Find the countries that contain a phrase.
+		 * @param phrase Decoded posting lists of the phrase words, in
+		 * phrase order.
+		 * @param outFound Element i is set to false if country i does not
+		 * contain the phrase. Other elements are not changed.
+		 */
+		void matchPhrase(
+			const MAUtil::Vector<const TermPostings*>& phrase,
+			MAUtil::Vector<bool>& outFound) const;
+
+	private:
+		/**
+		 * Number of indexed countries.
+		 */
+		int mCountCountries;
+
+		/**
+		 * True if the index can be searched.
+		 */
+		bool mIsBuilt;
+
+		/**
+		 * Element i is the number of words of country i.
+		 */
+		MAUtil::Vector<int> mCountryLengths;
+
+		/**
+		 * Average number of words of a country.
+		 */
+		double mAverageLength;
+
+		/**
+		 * Dictionary words sorted by their bytes.
+		 */
+		MAUtil::Vector<Term> mTerms;
+
+		/**
+		 * Texts of all dictionary words.
+		 */
+		MAUtil::String mTermTexts;
+
+		/**
+		 * Posting lists of all terms. For each country that contains a term:
+		 * country id delta, number of occurrences and the position deltas,
+		 * each one encoded on 7 bits per byte.
+		 */
+		MAUtil::Vector<unsigned char> mPostings;
+
+		/**
+		 * Word occurrences collected while building.
+		 */
+		MAUtil::Vector<Occurrence> mOccurrences;
+
+		/**
+		 * Element i is the position of the next word of country i.
+		 * Used while building.
+		 */
+		MAUtil::Vector<int> mNextPositions;
+
+		/**
+		 * Stores the words of mOccurrences.
+		 */
+		StringArena mBuildArena;
+
+	}; // end of CountryTextIndex
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_TEXT_INDEX_H_ */
@@ -0,0 +1,293 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryTextScanner.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Substring search over all country texts.
+ */
+
+// Initial size of the text buffer.
+#define SCANNER_INITIAL_CAPACITY (16 * 1024)
+
+#include <mastdlib.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "CountryTextScanner.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Find the null bytes of a word.
+	 * @param word Word to check.
+	 * @return A value that has the highest bit set for each null byte of
+	 * param word and all other bits cleared. Zero if no byte is null.
+	 */
+	static inline unsigned int findNullBytes(const unsigned int word)
+	{
+		unsigned int low = (word & 0x7F7F7F7Fu) + 0x7F7F7F7Fu;
+		return ~(low | word | 0x7F7F7F7Fu);
+	}
+
+	/**
+	 * Read a word from a position that may be unaligned.
+	 * @param data Position to read.
+	 * @return The word.
+	 */
+	static inline unsigned int readWord(const char* data)
+	{
+		unsigned int word;
+		memcpy(&word, data, sizeof(word));
+		return word;
+	}
+
+	/**
+	 * Constructor.
+	 */
+	CountryTextScanner::CountryTextScanner():
+		mBuffer(NULL),
+		mSize(0),
+		mCapacity(0),
+		mIsBuilt(false)
+	{
+	}
+
+	/**
+	 * Destructor.
+	 */
+	CountryTextScanner::~CountryTextScanner()
+	{
+		this->clear();
+	}
+
+	/**
+	 * Add a field of a country.
+	 * Fields must be added in country id order. A field is skipped if
+	 * the buffer cannot grow.
+	 * @param countryID Id of the country.
+	 * @param field Field that contains the text(SnapshotField value).
+	 * @param text Text to add. It does not need to be null terminated.
+	 * @param length Text length in bytes.
+	 */
+	void CountryTextScanner::addText(
+		const int countryID,
+		const int field,
+		const char* text,
+		const int length)
+	{
+		int size = mSize + length + 1;
+		if (size > mCapacity)
+		{
+			int capacity = mCapacity > 0 ? mCapacity : SCANNER_INITIAL_CAPACITY;
+			while (capacity < size)
+			{
+				capacity *= 2;
+			}
+			char* buffer = (char*) realloc(mBuffer, capacity);
+			if (!buffer)
+			{
+				return;
+			}
+			mBuffer = buffer;
+			mCapacity = capacity;
+		}
+
+		Segment segment;
+		segment.offset = mSize;
+		segment.countryID = countryID;
+		segment.field = field;
+		mSegments.add(segment);
+
+		memcpy(mBuffer + mSize, text, length);
+		mBuffer[mSize + length] = '\0';
+		mSize = size;
+	}
+
+	/**
+	 * Mark the scanner as ready. Must be called after the last
+	 * addText() call.
+	 */
+	void CountryTextScanner::endBuild()
+	{
+		mIsBuilt = true;
+	}
+
+	/**
+	 * Check if all texts were added.
+	 * @return true if endBuild() was called since the last clear().
+	 */
+	bool CountryTextScanner::isBuilt() const
+	{
+		return mIsBuilt;
+	}
+
+	/**
+	 * Find all occurrences of a text. Overlapping occurrences are
+	 * found too. Case is not ignored.
+	 * @param text Text to search.
+	 * @param outOccurrences Will contain the occurrences in country id
+	 * order.
+	 */
+	void CountryTextScanner::find(
+		const MAUtil::String& text,
+		MAUtil::Vector<CountryTextOccurrence>& outOccurrences) const
+	{
+		outOccurrences.clear();
+		const char* pattern = text.c_str();
+		int length = text.length();
+		if (length == 0 || length > mSize)
+		{
+			return;
+		}
+
+		// A candidate starts at a position where the first byte of the
+		// pattern is found and the last byte is found length - 1 bytes later.
+		// The null separators never match, so no match spans two fields.
+		int lastStart = mSize - length;
+		int position = 0;
+		int segment = 0;
+
+#ifdef __SSE2__
+		__m128i first = _mm_set1_epi8(pattern[0]);
+		__m128i last = _mm_set1_epi8(pattern[length - 1]);
+		for (; position + 15 <= lastStart; position += 16)
+		{
+			__m128i firstBlock = _mm_loadu_si128(
+				(const __m128i*) (mBuffer + position));
+			__m128i lastBlock = _mm_loadu_si128(
+				(const __m128i*) (mBuffer + position + length - 1));
+			int mask = _mm_movemask_epi8(_mm_and_si128(
+				_mm_cmpeq_epi8(firstBlock, first),
+				_mm_cmpeq_epi8(lastBlock, last)));
+			while (mask != 0)
+			{
+				int bit = 0;
+				while (!(mask & (1 << bit)))
+				{
+					bit++;
+				}
+				this->checkCandidate(position + bit, pattern, length,
+					segment, outOccurrences);
+				mask &= mask - 1;
+			}
+		}
+#endif
+
+		// Check 4 positions at a time. The byte order of the words does not
+		// matter: the 4 positions are checked one by one if any matches.
+		unsigned int first4 = (unsigned char) pattern[0] * 0x01010101u;
+		unsigned int last4 = (unsigned char) pattern[length - 1] * 0x01010101u;
+		for (; position + 3 <= lastStart; position += 4)
+		{
+			unsigned int difference =
+				(readWord(mBuffer + position) ^ first4) |
+				(readWord(mBuffer + position + length - 1) ^ last4);
+			if (findNullBytes(difference) == 0)
+			{
+				continue;
+			}
+			for (int index = position; index < position + 4; index++)
+			{
+				if (mBuffer[index] == pattern[0] &&
+					mBuffer[index + length - 1] == pattern[length - 1])
+				{
+					this->checkCandidate(index, pattern, length,
+						segment, outOccurrences);
+				}
+			}
+		}
+
+		for (; position <= lastStart; position++)
+		{
+			if (mBuffer[position] == pattern[0] &&
+				mBuffer[position + length - 1] == pattern[length - 1])
+			{
+				this->checkCandidate(position, pattern, length,
+					segment, outOccurrences);
+			}
+		}
+	}
+
+	/**
+	 * Remove all texts.
+	 */
+	void CountryTextScanner::clear()
+	{
+		free(mBuffer);
+		mBuffer = NULL;
+		mSize = 0;
+		mCapacity = 0;
+		mSegments.clear();
+		mIsBuilt = false;
+	}
+
+	/**
+	 * Get the size of the buffer that holds all texts.
+	 * @return Size in bytes.
+	 */
+	int CountryTextScanner::getSize() const
+	{
+		return mSize;
+	}
+
+	/**
+	 * Compare the searched text with the buffer at a given position, and
+	 * add an occurrence if they are equal. The first and last bytes
+	 * must already be equal.
+	 * @param position Position in the buffer.
+	 * @param text Searched text.
+	 * @param length Length of the searched text.
+	 * @param segment Index of a segment that starts before param
+	 * position. Will be set to the segment that contains it.
+	 * @param outOccurrences The occurrence is added to this array.
+	 */
+	void CountryTextScanner::checkCandidate(
+		const int position,
+		const char* text,
+		const int length,
+		int& segment,
+		MAUtil::Vector<CountryTextOccurrence>& outOccurrences) const
+	{
+		if (length > 2 &&
+			memcmp(mBuffer + position + 1, text + 1, length - 2) != 0)
+		{
+			return;
+		}
+
+		// Candidates are checked in buffer order, so the segment that
+		// contains the position is found by moving forward.
+		while (segment + 1 < mSegments.size() &&
+			mSegments[segment + 1].offset <= position)
+		{
+			segment++;
+		}
+
+		const Segment& found = mSegments[segment];
+		CountryTextOccurrence occurrence;
+		occurrence.countryID = found.countryID;
+		occurrence.field = found.field;
+		occurrence.offset = position - found.offset;
+		outOccurrences.add(occurrence);
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,198 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryTextScanner.h
+ * @author Bogdan Iusco
+ *
+ * @brief Substring search over all country texts.
+ */
+
+#ifndef EC_COUNTRY_TEXT_SCANNER_H_
+#define EC_COUNTRY_TEXT_SCANNER_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+#include "CountrySnapshot.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief An occurrence of a text found by a scan.
+	 */
+	struct CountryTextOccurrence
+	{
+		/**
+		 * Id of the country.
+		 */
+		int countryID;
+
+		/**
+		 * Field that contains the text(SnapshotField value).
+		 */
+		int field;
+
+		/**
+		 * Position of the text in the field, in bytes.
+		 */
+		int offset;
+	};
+
+	/**
+	 * @brief Finds all occurrences of a text in the country fields.
+	 * All fields are copied in one buffer, each one followed by a null
+	 * character, so a search is a single pass over contiguous memory.
+	 * Positions where both the first and the last byte of the searched
+	 * text match are found several bytes at a time(16 with SSE2, 4 with
+	 * plain integer operations), only those positions are compared.
+	 */
+	class CountryTextScanner
+	{
+	public:
+		/**
+		 * Constructor.
+		 */
+		CountryTextScanner();
+
+		/**
+		 * Destructor.
+		 */
+		~CountryTextScanner();
+
+		/**
+		 * Add a field of a country.
+		 * Fields must be added in country id order. A field is skipped if
+		 * the buffer cannot grow.
+		 * @param countryID Id of the country.
+		 * @param field Field that contains the text(SnapshotField value).
+		 * @param text Text to add. It does not need to be null terminated.
+		 * @param length Text length in bytes.
+		 */
+		void addText(
+			const int countryID,
+			const int field,
+			const char* text,
+			const int length);
+
+		/**
+		 * Mark the scanner as ready. Must be called after the last
+		 * addText() call.
+		 */
+		void endBuild();
+
+		/**
+		 * Check if all texts were added.
+		 * @return true if endBuild() was called since the last clear().
+		 */
+		bool isBuilt() const;
+
+		/**
+		 * Find all occurrences of a text. Overlapping occurrences are
+		 * found too. Case is not ignored.
+		 * @param text Text to search.
+		 * @param outOccurrences Will contain the occurrences in country id
+		 * order.
+		 */
+		void find(
+			const MAUtil::String& text,
+			MAUtil::Vector<CountryTextOccurrence>& outOccurrences) const;
+
+		/**
+		 * Remove all texts.
+		 */
+		void clear();
+
+		/**
+		 * Get the size of the buffer that holds all texts.
+		 * @return Size in bytes.
+		 */
+		int getSize() const;
+
+	private:
+		/**
+		 * A field stored in the buffer.
+		 */
+		struct Segment
+		{
+			/**
+			 * Position of the field in the buffer.
+			 */
+			int offset;
+
+			/**
+			 * Id of the country.
+			 */
+			int countryID;
+
+			/**
+			 * Field that contains the text(SnapshotField value).
+			 */
+			int field;
+		};
+
+		/**
+		 * Compare the searched text with the buffer at a given position, and
+		 * add an occurrence if they are equal. The first and last bytes
+		 * must already be equal.
+		 * @param position Position in the buffer.
+		 * @param text Searched text.
+		 * @param length Length of the searched text.
+		 * @param segment Index of a segment that starts before param
+		 * position. Will be set to the segment that contains it.
+		 * @param outOccurrences The occurrence is added to this array.
+		 */
+		void checkCandidate(
+			const int position,
+			const char* text,
+			const int length,
+			int& segment,
+			MAUtil::Vector<CountryTextOccurrence>& outOccurrences) const;
+
+	private:
+		/**
+		 * All texts, each one followed by a null character.
+		 */
+		char* mBuffer;
+
+		/**
+		 * Used size of mBuffer.
+		 */
+		int mSize;
+
+		/**
+		 * Allocated size of mBuffer.
+		 */
+		int mCapacity;
+
+		/**
+		 * Fields stored in mBuffer, in buffer order.
+		 */
+		MAUtil::Vector<Segment> mSegments;
+
+		/**
+		 * True if all texts were added.
+		 */
+		bool mIsBuilt;
+
+	}; // end of CountryTextScanner
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_TEXT_SCANNER_H_ */
@@ -26,25 +26,192 @@
 #define CHECKSUM_BUF_SIZE 128
 
 #define BUNDLE_CHECKSUM "ECProjectChecksum"
+#define CACHE_FILE_NAME "ECCountryCache"
 #define COUNTRY_TABLE_FILE_NAME "CountryTable"
 
+// Default number of country files read by a load job.
+#define LOAD_JOB_SIZE 256
+
+// Time given to continueLoading() by readDataFromFiles(), large enough to
+// read all files in one call.
+#define LOAD_TIME_UNLIMITED 0x7FFFFFFF
+
+// Maximum number of countries that keep their detail fields loaded.
+#define DETAILS_CACHE_SIZE 8
+
+// Handle of the LocalFiles.bin resource(first entry in Resources.lst).
+#define LOCAL_FILES_RESOURCE 1
+
 #include <conprint.h>
 #include <mastdlib.h>
-#include <yajl/YAJLDom.h>
 #include <Wormhole/FileUtil.h>
 
+#include "BundleFileReader.h"
 #include "Country.h"
+#include "CountryDatabaseObserver.h"
+#include "CountryLoadJob.h"
+#include "CountrySnapshot.h"
 #include "DatabaseManager.h"
+#include "LocalFileReader.h"
+#include "LocalFilesExtractor.h"
 #include "ModelUtils.h"
 
 namespace EuropeanCountries
 {
+	/**
+	 * @brief Adds the fields of each country to the full text index and
+	 * to the text scanner. Used by DatabaseManager::buildTextIndexes().
+	 * Countries must be passed in id order.
+	 */
+	class TextIndexBuilder:
+		public IFileBatchListener
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param countries All countries, indexed by id.
+		 * @param countryParser Used to parse the detail fields.
+		 * @param textIndex Index that receives the detail fields.
+		 * @param textScanner Scanner that receives all fields.
+		 */
+		TextIndexBuilder(
+			const MAUtil::Vector<Country*>& countries,
+			CountryParser& countryParser,
+			CountryTextIndex& textIndex,
+			CountryTextScanner& textScanner):
+			mCountries(countries),
+			mCountryParser(countryParser),
+			mTextIndex(textIndex),
+			mTextScanner(textScanner)
+		{
+		}
+
+		/**
+		 * Add the fields of a country.
+		 * From IFileBatchListener.
+		 * @param index Id of the country.
+		 * @param content Content of the country file, or NULL if it
+		 * could not be read. Not used if the details of the country
+		 * are loaded.
+		 * @param size Content size in bytes.
+		 */
+		virtual void fileRead(
+			const int index,
+			const char* content,
+			const int size)
+		{
+			Country* country = mCountries[index];
+			StringSlice name = country->getNameSlice();
+			StringSlice capital = country->getCapitalSlice();
+			StringSlice population = country->getPopulationSlice();
+			StringSlice area = country->getAreaSlice();
+			mTextScanner.addText(index, SnapshotFieldName,
+				name.text, name.length);
+			mTextScanner.addText(index, SnapshotFieldCapital,
+				capital.text, capital.length);
+			mTextScanner.addText(index, SnapshotFieldPopulation,
+				population.text, population.length);
+			mTextScanner.addText(index, SnapshotFieldArea,
+				area.text, area.length);
+
+			// Details are parsed into a temporary country, so the details
+			// cache is not changed.
+			Country details(country->getID());
+			if (!country->hasDetails())
+			{
+				if (!content ||
+					!mCountryParser.parseCountry(content, size, details,
+						CountryDetailFields))
+				{
+					printf("Cannot read details from %s",
+						country->getFileName().c_str());
+					return;
+				}
+				country = &details;
+			}
+
+			StringSlice languages = country->getLanguagesSlice();
+			StringSlice government = country->getGovernmentSlice();
+			mTextIndex.addText(index, languages.text, languages.length);
+			mTextIndex.addText(index, government.text, government.length);
+			mTextScanner.addText(index, SnapshotFieldLanguages,
+				languages.text, languages.length);
+			mTextScanner.addText(index, SnapshotFieldGovernment,
+				government.text, government.length);
+		}
+
+	private:
+		/**
+		 * All countries, indexed by id.
+		 */
+		const MAUtil::Vector<Country*>& mCountries;
+
+		/**
+		 * Used to parse the detail fields.
+		 */
+		CountryParser& mCountryParser;
+
+		/**
+		 * Index that receives the detail fields.
+		 */
+		CountryTextIndex& mTextIndex;
+
+		/**
+		 * Scanner that receives all fields.
+		 */
+		CountryTextScanner& mTextScanner;
+
+	}; // end of TextIndexBuilder
+
 	/**
 	 * Constructor.
+	 * Data files will be read directly from the LocalFiles.bin resource.
 	 */
 	DatabaseManager::DatabaseManager():
 		mFileUtil(NULL),
-		mCountryFileNames(NULL)
+		mFileReader(NULL),
+		mOwnsFileReader(true),
+		mReadFromBundle(true),
+		mUsesExtractedFiles(false),
+		mCacheEnabled(true),
+		mLoadJobSize(LOAD_JOB_SIZE),
+		mIsLoading(false),
+		mNextFileIndex(0),
+		mLoadChecksum(0),
+		mCountryParser(mStringArena),
+		mCountryFileNames(NULL),
+		mKeyIndex(mCountriesArray),
+		mSortIndex(mSummaryTable),
+		mSearchIndex(mSummaryTable),
+		mFuzzyIndex(mSummaryTable)
+	{
+		mFileUtil = new Wormhole::FileUtil();
+	}
+
+	/**
+	 * Constructor.
+	 * Data files will be read using a given file reader. Files from
+	 * LocalFiles.bin will not be extracted.
+	 * @param fileReader Used to read the data files.
+	 * Its ownership is NOT passed to the database.
+	 */
+	DatabaseManager::DatabaseManager(IFileReader& fileReader):
+		mFileUtil(NULL),
+		mFileReader(&fileReader),
+		mOwnsFileReader(false),
+		mReadFromBundle(false),
+		mUsesExtractedFiles(false),
+		mCacheEnabled(false),
+		mLoadJobSize(LOAD_JOB_SIZE),
+		mIsLoading(false),
+		mNextFileIndex(0),
+		mLoadChecksum(0),
+		mCountryParser(mStringArena),
+		mCountryFileNames(NULL),
+		mKeyIndex(mCountriesArray),
+		mSortIndex(mSummaryTable),
+		mSearchIndex(mSummaryTable),
+		mFuzzyIndex(mSummaryTable)
 	{
 		mFileUtil = new Wormhole::FileUtil();
 	}
@@ -54,20 +221,177 @@ namespace EuropeanCountries
 	 */
 	DatabaseManager::~DatabaseManager()
 	{
-		mCountryFileNames.clear();
-		mCountriesMap.clear();
+		mObservers.clear();
+		this->clearData();
+		if (mOwnsFileReader)
+		{
+			delete mFileReader;
+		}
 		delete mFileUtil;
 	}
 
 	/**
-	 * Extract files from LocalFiles.bin(if needed) and read country data.
+	 * Read country data from the LocalFiles.bin resource.
+	 * If LocalFiles.bin did not change since the last launch, data is
+	 * restored from the cache file written by the previous launch.
+	 * Only the summary fields are read, detail fields are read by
+	 * loadCountryDetails().
 	 * This operation is synchronous and it takes time.
 	 */
 	void DatabaseManager::readDataFromFiles()
 	{
-		this->extractLocalFiles();
+		this->beginLoading();
+		while (this->continueLoading(LOAD_TIME_UNLIMITED))
+		{
+		}
+	}
+
+	/**
+	 * Start reading country data from the LocalFiles.bin resource.
+	 * Previously read data is removed. Only the CountryTable file is read,
+	 * country files are read by continueLoading().
+	 * If LocalFiles.bin did not change since the last launch, data is
+	 * restored from the cache file at once and no loading remains.
+	 */
+	void DatabaseManager::beginLoading()
+	{
+		this->clearData();
+		mLoadStatistics.reset();
+		mIsLoading = false;
+		mNextFileIndex = 0;
+		mLoadChecksum = 0;
+		int startTime = maGetMilliSecondCount();
+
+		if (mReadFromBundle)
+		{
+			// On warm start the cache holds the data read on first launch.
+			mLoadChecksum =
+				mFileUtil->getFileSystemChecksum(LOCAL_FILES_RESOURCE);
+			if (mCacheEnabled && this->readCacheFile(mLoadChecksum))
+			{
+				mLoadStatistics.totalTime = maGetMilliSecondCount() - startTime;
+				return;
+			}
+		}
+
 		this->readCountryTableFile();
-		this->readAllCountryFiles();
+		mLoadStatistics.countryTableTime = maGetMilliSecondCount() - startTime;
+		mLoadStatistics.totalTime = mLoadStatistics.countryTableTime;
+
+		int countFiles = mCountryFileNames.size();
+		mCountriesArray.reserve(countFiles);
+		mSummaryTable.reserve(countFiles);
+		mIsLoading = true;
+		if (countFiles == 0)
+		{
+			this->finishLoading();
+		}
+	}
+
+	/**
+	 * Read the next country files listed in the CountryTable file.
+	 * Files are read in load jobs of mLoadJobSize files, until the given
+	 * time is spent. At least one job is run. Jobs are merged in
+	 * CountryTable order, so the ids do not depend on the job size.
+	 * @param maxTime Time after which no new job is started, in
+	 * milliseconds.
+	 * @return true if files remain to be read, false otherwise.
+	 */
+	bool DatabaseManager::continueLoading(const int maxTime)
+	{
+		if (!mIsLoading)
+		{
+			return false;
+		}
+
+		int startTime = maGetMilliSecondCount();
+		int countFiles = mCountryFileNames.size();
+		do
+		{
+			int endIndex = mNextFileIndex + mLoadJobSize;
+			if (endIndex > countFiles)
+			{
+				endIndex = countFiles;
+			}
+
+			CountryLoadJob job(mCountryFileNames, mNextFileIndex, endIndex);
+			this->runLoadJob(job);
+			this->mergeLoadJob(job);
+			mNextFileIndex = endIndex;
+		}
+		while (mNextFileIndex < countFiles &&
+			maGetMilliSecondCount() - startTime < maxTime);
+
+		int time = maGetMilliSecondCount() - startTime;
+		mLoadStatistics.countryFilesTime += time;
+		mLoadStatistics.totalTime += time;
+		if (mNextFileIndex == countFiles)
+		{
+			this->finishLoading();
+		}
+		return mIsLoading;
+	}
+
+	/**
+	 * Check if country files remain to be read by continueLoading().
+	 * @return true if loading is not finished, false otherwise.
+	 */
+	bool DatabaseManager::isLoading() const
+	{
+		return mIsLoading;
+	}
+
+	/**
+	 * Get the number of CountryTable files already read.
+	 * @return Number of files.
+	 */
+	int DatabaseManager::countLoadedFiles() const
+	{
+		return mNextFileIndex;
+	}
+
+	/**
+	 * Get the number of files listed in the CountryTable file.
+	 * @return Number of files, zero if data was restored from the cache.
+	 */
+	int DatabaseManager::countFilesToLoad() const
+	{
+		return mCountryFileNames.size();
+	}
+
+	/**
+	 * Read country data from a snapshot image created by writeSnapshot().
+	 * Previously read data is removed.
+	 * @param filePath Path of the snapshot file.
+	 * @return true if the data was read, false otherwise.
+	 */
+	bool DatabaseManager::readDataFromSnapshot(const MAUtil::String& filePath)
+	{
+		mLoadStatistics.reset();
+		int startTime = maGetMilliSecondCount();
+
+		CountrySnapshot snapshot;
+		if (!snapshot.load(filePath))
+		{
+			return false;
+		}
+		this->createCountriesFromSnapshot(snapshot);
+
+		mLoadStatistics.totalTime = maGetMilliSecondCount() - startTime;
+		return true;
+	}
+
+	/**
+	 * Write all country data to a snapshot image.
+	 * @param filePath Path of the snapshot file.
+	 * @param checksum Value saved in the snapshot header.
+	 * @return true if the snapshot was written, false otherwise.
+	 */
+	bool DatabaseManager::writeSnapshot(
+		const MAUtil::String& filePath,
+		const int checksum)
+	{
+		return CountrySnapshot::write(filePath, mCountriesArray, checksum);
 	}
 
 	/**
@@ -88,7 +412,10 @@ namespace EuropeanCountries
 	Country* DatabaseManager::getCountryByID(const int id)
 	{
 		Country* country = NULL;
-		country = mCountriesMap[id];
+		if (id >= 0 && id < mCountriesArray.size())
+		{
+			country = mCountriesArray[id];
+		}
 		return country;
 	}
 
@@ -108,6 +435,395 @@ namespace EuropeanCountries
 		return country;
 	}
 
+	/**
+	 * Get a country for a given name, e.g. "Bosnia and Herzegovina".
+	 * @param name Given name. Case is ignored for ASCII letters.
+	 * @return Country with given name if it exists, otherwise NULL.
+	 * The ownership of the result is NOT passed to the caller.
+	 */
+	Country* DatabaseManager::getCountryByName(const MAUtil::String& name)
+	{
+		return this->getCountryByID(
+			mKeyIndex.find(CountryKeyName, name.c_str(), name.length()));
+	}
+
+	/**
+	 * Get a country for a given capital, e.g. "Sarajevo".
+	 * @param capital Given capital. Case is ignored for ASCII letters.
+	 * @return Country with given capital if it exists, otherwise NULL.
+	 * The ownership of the result is NOT passed to the caller.
+	 */
+	Country* DatabaseManager::getCountryByCapital(const MAUtil::String& capital)
+	{
+		return this->getCountryByID(mKeyIndex.find(CountryKeyCapital,
+			capital.c_str(), capital.length()));
+	}
+
+	/**
+	 * Get a country for a given file name from the CountryTable file,
+	 * e.g. "Bosnia_and_Herzegovina".
+	 * @param fileName Given file name. Case is ignored for ASCII letters.
+	 * @return Country read from given file if it exists, otherwise NULL.
+	 * The ownership of the result is NOT passed to the caller.
+	 */
+	Country* DatabaseManager::getCountryByFileName(
+		const MAUtil::String& fileName)
+	{
+		return this->getCountryByID(mKeyIndex.find(CountryKeyFileName,
+			fileName.c_str(), fileName.length()));
+	}
+
+	/**
+	 * Load the detail fields(languages and government) of a given country.
+	 * Only the last DETAILS_CACHE_SIZE countries keep their details loaded.
+	 * @param country Country that will be displayed.
+	 * @return true if the details are loaded, false otherwise.
+	 */
+	bool DatabaseManager::loadCountryDetails(Country& country)
+	{
+		// Move the country to the end of the cache(most recently used).
+		for (int index = 0; index < mDetailsCache.size(); index++)
+		{
+			if (mDetailsCache[index] == &country)
+			{
+				mDetailsCache.remove(index);
+				break;
+			}
+		}
+
+		if (!country.hasDetails())
+		{
+			MAUtil::String fileContent;
+			if (!this->getFileReader().readTextFromFile(
+					country.getFileName(), fileContent) ||
+				!mCountryParser.parseCountry(fileContent.c_str(),
+					fileContent.size(), country, CountryDetailFields))
+			{
+				printf("Cannot read details from %s",
+					country.getFileName().c_str());
+				return false;
+			}
+		}
+		mDetailsCache.add(&country);
+
+		// Release the least recently used details.
+		if (mDetailsCache.size() > DETAILS_CACHE_SIZE)
+		{
+			mDetailsCache[0]->clearDetails();
+			mDetailsCache.remove(0);
+		}
+		return true;
+	}
+
+	/**
+	 * Get the table with the fields used by the countries list.
+	 * Reading the list fields from it is faster than reading them
+	 * from the Country objects.
+	 * @return The summary table. Row indexes are country ids.
+	 */
+	const CountrySummaryTable& DatabaseManager::getSummaryTable()
+	{
+		return mSummaryTable;
+	}
+
+	/**
+	 * Get the country ids sorted by a given field.
+	 * The order is computed once and reused until the data changes.
+	 * @param field Field used to sort.
+	 * @param ascending If true the smallest value comes first.
+	 * @return Sorted country ids. It is valid until the data changes.
+	 */
+	const MAUtil::Vector<int>& DatabaseManager::getSortedCountryIDs(
+		const CountrySortField field,
+		const bool ascending)
+	{
+		return mSortIndex.getSortedIDs(field, ascending);
+	}
+
+	/**
+	 * Find the countries whose name or capital contains a word that
+	 * starts with a given text. Case is ignored for ASCII letters.
+	 * Searching for a text that extends the previous one(as the user
+	 * types) only checks the previous results.
+	 * @param text Text typed by the user.
+	 * @param order Country ids in list order, e.g. from
+	 * getSortedCountryIDs(). The position of each id is computed once
+	 * for an array returned by getSortedCountryIDs(), and by every call
+	 * for any other array.
+	 * @param outMatches Will contain a match for each found country,
+	 * in the order given by param order.
+	 */
+	void DatabaseManager::searchCountries(
+		const MAUtil::String& text,
+		const MAUtil::Vector<int>& order,
+		MAUtil::Vector<CountryMatch>& outMatches)
+	{
+		mSearchIndex.search(text, order, mSortIndex.getVersion(order),
+			outMatches);
+	}
+
+	/**
+	 * Find the countries whose name or capital contains a given text
+	 * with a few typing mistakes, e.g. "Chech Republic".
+	 * @param text Text typed by the user. Case is ignored for ASCII
+	 * letters.
+	 * @param maxResults Maximum number of returned countries.
+	 * @param outMatches Will contain the found countries, the best
+	 * match first.
+	 */
+	void DatabaseManager::findCountriesFuzzy(
+		const MAUtil::String& text,
+		const int maxResults,
+		MAUtil::Vector<CountryFuzzyMatch>& outMatches)
+	{
+		mFuzzyIndex.search(text, maxResults, outMatches);
+	}
+
+	/**
+	 * Search the languages and government texts of all countries.
+	 * Countries that contain any of the query words are ranked by
+	 * relevance. Words between double quotes form a phrase that must
+	 * be found as it is, e.g. "parliamentary republic".
+	 * @param query Words to search. Case is ignored for ASCII letters.
+	 * @param outMatches Will contain the found countries, the most
+	 * relevant first.
+	 * The index is built by the first search, so the detail fields are
+	 * not parsed at startup.
+	 */
+	void DatabaseManager::searchCountryText(
+		const MAUtil::String& query,
+		MAUtil::Vector<CountryTextMatch>& outMatches)
+	{
+		if (!mTextIndex.isBuilt())
+		{
+			this->buildTextIndexes();
+		}
+		mTextIndex.search(query, outMatches);
+	}
+
+	/**
+	 * Find all occurrences of a text in the country fields(name,
+	 * capital, population, area, languages and government).
+	 * Unlike searchCountryText() it finds any part of a word,
+	 * punctuation and numbers. Case is not ignored.
+	 * @param text Text to search.
+	 * @param outOccurrences Will contain the occurrences in country
+	 * id order.
+	 * The texts are copied in one buffer by the first scan.
+	 */
+	void DatabaseManager::scanCountryText(
+		const MAUtil::String& text,
+		MAUtil::Vector<CountryTextOccurrence>& outOccurrences)
+	{
+		if (!mTextScanner.isBuilt())
+		{
+			this->buildTextIndexes();
+		}
+		mTextScanner.find(text, outOccurrences);
+	}
+
+	/**
+	 * Add an observer that will be notified when countries are added
+	 * or removed, e.g. while the database is loading.
+	 * @param observer The observer. Its ownership is NOT passed to the
+	 * database.
+	 */
+	void DatabaseManager::addObserver(CountryDatabaseObserver& observer)
+	{
+		mObservers.add(&observer);
+	}
+
+	/**
+	 * Remove an observer added by addObserver().
+	 * @param observer The observer.
+	 */
+	void DatabaseManager::removeObserver(CountryDatabaseObserver& observer)
+	{
+		for (int index = 0; index < mObservers.size(); index++)
+		{
+			if (mObservers[index] == &observer)
+			{
+				mObservers.remove(index);
+				return;
+			}
+		}
+	}
+
+	/**
+	 * Get the measurements collected by the last readDataFromFiles() call.
+	 * @return Load statistics.
+	 */
+	const LoadStatistics& DatabaseManager::getLoadStatistics() const
+	{
+		return mLoadStatistics;
+	}
+
+	/**
+	 * Enable or disable the cache file used on warm start.
+	 * The cache is enabled by default only when reading from LocalFiles.bin.
+	 * @param enabled If true data is restored from and saved to the cache.
+	 */
+	void DatabaseManager::setCacheEnabled(const bool enabled)
+	{
+		mCacheEnabled = enabled;
+	}
+
+	/**
+	 * Set the number of country files read by each load job.
+	 * Results do not depend on it, only the load time and the memory
+	 * used while loading do.
+	 * @param countFiles Number of files. Values smaller than one are
+	 * replaced with one.
+	 */
+	void DatabaseManager::setLoadJobSize(const int countFiles)
+	{
+		mLoadJobSize = countFiles > 0 ? countFiles : 1;
+	}
+
+	/**
+	 * Delete all countries and clear data read from files.
+	 * Observers are notified if countries were removed.
+	 */
+	void DatabaseManager::clearData()
+	{
+		bool hadCountries = mCountriesArray.size() > 0;
+		for (int index = 0; index < mCountriesArray.size(); index++)
+		{
+			delete mCountriesArray[index];
+		}
+		mCountriesArray.clear();
+		mSummaryTable.clear();
+		mKeyIndex.invalidate();
+		mSortIndex.invalidate();
+		mSearchIndex.invalidate();
+		mFuzzyIndex.invalidate();
+		mTextIndex.clear();
+		mTextScanner.clear();
+		mCountryFileNames.clear();
+		mDetailsCache.clear();
+		mStringArena.clear();
+		if (hadCountries)
+		{
+			this->notifyCountriesRemoved();
+		}
+	}
+
+	/**
+	 * Create countries from a loaded snapshot image.
+	 * Previously read data is removed. The image is moved into the string
+	 * arena, so texts are not copied. Observers are notified that
+	 * countries were added and that loading finished.
+	 * @param snapshot Snapshot that contains the data.
+	 */
+	void DatabaseManager::createCountriesFromSnapshot(CountrySnapshot& snapshot)
+	{
+		this->clearData();
+		int countCountries = snapshot.countCountries();
+		mCountriesArray.reserve(countCountries);
+		mSummaryTable.reserve(countCountries);
+		for (int index = 0; index < countCountries; index++)
+		{
+			Country* country = new Country(index);
+			snapshot.fillCountry(index, *country);
+			mCountriesArray.add(country);
+			mSummaryTable.addRow(*country);
+		}
+
+		mLoadStatistics.countCountries = countCountries;
+		mLoadStatistics.bytesRead = snapshot.getImageSize();
+		mStringArena.adopt(snapshot.releaseImage());
+		if (countCountries > 0)
+		{
+			this->notifyCountriesAdded(0, countCountries);
+		}
+		this->notifyLoadingFinished();
+	}
+
+	/**
+	 * Build the full text index and the text scanner from the fields
+	 * of all countries.
+	 * Details that are not loaded are read from the country files.
+	 */
+	void DatabaseManager::buildTextIndexes()
+	{
+		int countCountries = mCountriesArray.size();
+		MAUtil::Vector<MAUtil::String> fileNames;
+		fileNames.reserve(countCountries);
+		for (int index = 0; index < countCountries; index++)
+		{
+			fileNames.add(mCountriesArray[index]->getFileName());
+		}
+
+		TextIndexBuilder builder(mCountriesArray, mCountryParser,
+			mTextIndex, mTextScanner);
+		mTextIndex.beginBuild(countCountries);
+		mTextScanner.clear();
+		int index = 0;
+		while (index < countCountries)
+		{
+			if (mCountriesArray[index]->hasDetails())
+			{
+				builder.fileRead(index, NULL, 0);
+				index++;
+				continue;
+			}
+
+			// The files of consecutive countries without details are read
+			// as one batch, so the bundle is mounted once for all of them.
+			int endIndex = index + 1;
+			while (endIndex < countCountries &&
+				!mCountriesArray[endIndex]->hasDetails())
+			{
+				endIndex++;
+			}
+			this->getFileReader().readTextFromFiles(fileNames, index, endIndex,
+				builder);
+			index = endIndex;
+		}
+		mTextIndex.endBuild();
+		mTextScanner.endBuild();
+	}
+
+	/**
+	 * Restore data from the cache file.
+	 * @param checksum Checksum of LocalFiles.bin. The cache is used only
+	 * if it was written for the same checksum.
+	 * @return true if data was restored, false otherwise.
+	 */
+	bool DatabaseManager::readCacheFile(const int checksum)
+	{
+		MAUtil::String filePath = mFileUtil->getLocalPath() + CACHE_FILE_NAME;
+		CountrySnapshot snapshot;
+		if (!snapshot.load(filePath) ||
+			snapshot.getChecksum() != checksum ||
+			snapshot.countCountries() == 0)
+		{
+			return false;
+		}
+
+		this->createCountriesFromSnapshot(snapshot);
+		mLoadStatistics.loadedFromCache = true;
+		return true;
+	}
+
+	/**
+	 * Write all country data to the cache file.
+	 * @param checksum Checksum of LocalFiles.bin used to read the data.
+	 */
+	void DatabaseManager::writeCacheFile(const int checksum)
+	{
+		if (mCountriesArray.size() == 0)
+		{
+			return;
+		}
+
+		MAUtil::String filePath = mFileUtil->getLocalPath() + CACHE_FILE_NAME;
+		if (!CountrySnapshot::write(filePath, mCountriesArray, checksum))
+		{
+			printf("Cannot write %s", filePath.c_str());
+		}
+	}
+
 	/**
 	 * Reads the CountryTable file.
 	 * Data will be written into mCountryFileNames.
@@ -117,100 +833,178 @@ namespace EuropeanCountries
 		// Reset array.
 		mCountryFileNames.clear();
 
-		// Open CountryTable file.
-		MAUtil::String filePath = mFileUtil->getLocalPath() + COUNTRY_TABLE_FILE_NAME;
+		// Open CountryTable file. If it cannot be read in place from
+		// LocalFiles.bin, the bundle is extracted and all files are read
+		// from the local file system.
 		MAUtil::String fileContent;
-		if (!mFileUtil->readTextFromFile(filePath, fileContent))
+		bool isRead = this->getFileReader().readTextFromFile(
+			COUNTRY_TABLE_FILE_NAME, fileContent);
+		if (!isRead && mReadFromBundle && !mUsesExtractedFiles)
+		{
+			this->useExtractedFiles();
+			isRead = mFileReader->readTextFromFile(
+				COUNTRY_TABLE_FILE_NAME, fileContent);
+		}
+		if (!isRead)
 		{
 			printf("Cannot read text from CountryTable");
 			return;
 		}
+		mLoadStatistics.bytesRead += fileContent.size();
 
-		//Read file content.
-		MAUtil::YAJLDom::Value* root = MAUtil::YAJLDom::parse(
-			(const unsigned char*)fileContent.c_str(), fileContent.size());
-		MAUtil::YAJLDom::Value* countries = root->getValueForKey(sCountriesKey);
-		MAUtil::YAJLDom::ArrayValue* countriesArray = (MAUtil::YAJLDom::ArrayValue*) countries;
-		MAUtil::Vector<MAUtil::YAJLDom::Value*> allCountries = countriesArray->getValues();
+		// Read file content.
+		if (!mCountryParser.parseCountryTable(
+			fileContent.c_str(), fileContent.size(), mCountryFileNames))
+		{
+			printf("Cannot parse CountryTable");
+		}
+	}
 
-		// Get all country files that we should read next.
-		for (int index = 0; index < allCountries.size(); index++)
+	/**
+	 * Called after the last country file was read.
+	 * The cache file is written if it is enabled and observers are
+	 * notified.
+	 */
+	void DatabaseManager::finishLoading()
+	{
+		mIsLoading = false;
+		mLoadStatistics.countCountries = mCountriesArray.size();
+		if (mCacheEnabled && mLoadChecksum != 0)
 		{
-			MAUtil::YAJLDom::Value* countryValue = allCountries[index];
-			MAUtil::String countryFileName = countryValue->toString();
-			mCountryFileNames.add(countryFileName);
+			this->writeCacheFile(mLoadChecksum);
 		}
-		delete root;
+		this->notifyLoadingFinished();
 	}
 
 	/**
-	 * Read all country files specified in the CountryTable file.
-	 * Data will be written into mCountries.
+	 * Read and parse the files of a load job.
+	 * A file that cannot be read or parsed is reported and skipped.
+	 * @param job Job to run.
 	 */
-	void DatabaseManager::readAllCountryFiles()
+	void DatabaseManager::runLoadJob(CountryLoadJob& job)
 	{
-		for (int index = 0; index < mCountryFileNames.size(); index++)
+		job.run(this->getFileReader());
+		mLoadStatistics.bytesRead += job.getBytesRead();
+	}
+
+	/**
+	 * Add the countries of a load job that was run.
+	 * The job numbers the countries by CountryTable index; they are
+	 * renumbered so that ids stay the indexes in mCountriesArray when
+	 * files were skipped.
+	 * @param job Job that contains the countries. It is left empty.
+	 */
+	void DatabaseManager::mergeLoadJob(CountryLoadJob& job)
+	{
+		int firstID = mCountriesArray.size();
+		job.takeResults(mStringArena, mCountriesArray);
+		for (int id = firstID; id < mCountriesArray.size(); id++)
 		{
-			MAUtil::String countryFileName = mCountryFileNames[index];
-			this->readCountryFile(countryFileName);
+			Country* country = mCountriesArray[id];
+			country->setID(id);
+			mSummaryTable.addRow(*country);
+		}
+
+		int countAdded = mCountriesArray.size() - firstID;
+		if (countAdded > 0)
+		{
+			// The text indexes do not list the new countries, so they are
+			// built again by the next search.
+			mTextIndex.clear();
+			mTextScanner.clear();
+			this->notifyCountriesAdded(firstID, countAdded);
 		}
 	}
 
 	/**
-	 * Read a given country file.
-	 * Data will be added into mCountries.
-	 * @param countryFileName File name to read.
+	 * Notify the observers that countries were added.
+	 * @param firstID Id of the first added country.
+	 * @param countCountries Number of added countries.
 	 */
-	void DatabaseManager::readCountryFile(MAUtil::String& countryFileName)
+	void DatabaseManager::notifyCountriesAdded(
+		const int firstID,
+		const int countCountries)
 	{
-		// Open and read file content.
-		MAUtil::String filePath = mFileUtil->getLocalPath() + countryFileName;
-		MAUtil::String fileContent;
-		if (!mFileUtil->readTextFromFile(filePath, fileContent))
+		for (int index = 0; index < mObservers.size(); index++)
 		{
-			printf("Cannot read text from %s", filePath.c_str());
-			return;
+			mObservers[index]->countriesAdded(firstID, countCountries);
+		}
+	}
+
+	/**
+	 * Notify the observers that all countries were removed.
+	 */
+	void DatabaseManager::notifyCountriesRemoved()
+	{
+		for (int index = 0; index < mObservers.size(); index++)
+		{
+			mObservers[index]->countriesRemoved();
+		}
+	}
+
+	/**
+	 * Notify the observers that the database is fully loaded.
+	 */
+	void DatabaseManager::notifyLoadingFinished()
+	{
+		for (int index = 0; index < mObservers.size(); index++)
+		{
+			mObservers[index]->loadingFinished();
 		}
+	}
 
-		// Extract JSON values.
-		MAUtil::YAJLDom::Value* root = MAUtil::YAJLDom::parse(
-			(const unsigned char*)fileContent.c_str(), fileContent.size());
-		MAUtil::String name = root->getValueForKey(sCountryNameKey)->toString();
-		int flagID = root->getValueForKey(sCountryFlagIDKey)->toInt();
-		MAUtil::String population = root->getValueForKey(sCountryPopulationKey)->toString();
-		MAUtil::String area = root->getValueForKey(sCountryAreaKey)->toString();
-		MAUtil::String languages = root->getValueForKey(sCountryLanguagesKey)->toString();
-		MAUtil::String government = root->getValueForKey(sCountryGovernmentKey)->toString();
-		MAUtil::String capital = root->getValueForKey(sCountryCapitalKey)->toString();
+	/**
+	 * Get the reader used for the data files.
+	 * The LocalFiles.bin reader is created by the first call.
+	 * @return The file reader.
+	 */
+	IFileReader& DatabaseManager::getFileReader()
+	{
+		if (!mFileReader && mReadFromBundle)
+		{
+			mFileReader = new BundleFileReader(LOCAL_FILES_RESOURCE);
+		}
+		return *mFileReader;
+	}
+
+	/**
+	 * Replace the LocalFiles.bin reader with one that reads files
+	 * extracted to the local file system.
+	 * Used only if the bundle cannot be read in place.
+	 */
+	void DatabaseManager::useExtractedFiles()
+	{
+		int startTime = maGetMilliSecondCount();
 
-		// Create and fill Country object with read data.
-		Country* country = new Country();
-		country->setName(name);
-		country->setFlagID(flagID);
-		country->setPopulation(population);
-		country->setArea(area);
-		country->setLanguages(languages);
-		country->setGovernment(government);
-		country->setCapital(capital);
+		// The bundle reader must be released before extracting, as the
+		// extractor mounts the bundle too.
+		delete mFileReader;
+		mFileReader = NULL;
 
-		// Add object to map and array.
-		mCountriesMap.insert(country->getID(), country);
-		mCountriesArray.add(country);
+		this->extractLocalFiles();
+		mFileReader = new LocalFileReader(mFileUtil->getLocalPath());
+		mUsesExtractedFiles = true;
 
-		// Delete JSON root object.
-		delete root;
+		mLoadStatistics.extractTime += maGetMilliSecondCount() - startTime;
 	}
 
 	/**
 	 * Extract LocalFile.bin to the local file system.
-	 * Files will be extracted only if the checksum does not match.
+	 * Files will be extracted only if the checksum does not match, and
+	 * then only new or changed files are written.
 	 */
 	void DatabaseManager::extractLocalFiles()
 	{
 		if (this->checksumHasChanged())
 		{
-			// Extract bundled files to the local file system.
-			mFileUtil->extractLocalFiles();
+			// Extract only the files that changed since the last extraction.
+			// If that fails extract the whole bundle.
+			LocalFilesExtractor extractor(
+				LOCAL_FILES_RESOURCE, mFileUtil->getLocalPath());
+			if (!extractor.extract())
+			{
+				mFileUtil->extractLocalFiles();
+			}
 
 			// Write the current checksum.
 			this->writeChecksum();
@@ -232,7 +1026,7 @@ namespace EuropeanCountries
 		filePath += BUNDLE_CHECKSUM;
 
 		// Read checksum of the file system bundle.
-		int checksum = mFileUtil->getFileSystemChecksum(1);
+		int checksum = mFileUtil->getFileSystemChecksum(LOCAL_FILES_RESOURCE);
 
 		// Read checksum from file and compare.
 		MAUtil::String data;
@@ -252,7 +1046,7 @@ namespace EuropeanCountries
 	void DatabaseManager::writeChecksum()
 	{
 		// Get checksum of the file system bundle.
-		int checksum = mFileUtil->getFileSystemChecksum(1);
+		int checksum = mFileUtil->getFileSystemChecksum(LOCAL_FILES_RESOURCE);
 
 		// Checksum file path.
 		MAUtil::String filePath = mFileUtil->getLocalPath();
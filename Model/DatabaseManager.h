@@ -26,11 +26,20 @@
 #ifndef EC_DATABASE_MANAGER_H_
 #define EC_DATABASE_MANAGER_H_
 
-#include <MAUtil/Map.h>
 #include <MAUtil/String.h>
 #include <MAUtil/Vector.h>
 
+#include "CountryFuzzyIndex.h"
+#include "CountryKeyIndex.h"
+#include "CountryParser.h"
+#include "CountrySearchIndex.h"
+#include "CountrySortIndex.h"
+#include "CountrySummaryTable.h"
+#include "CountryTextIndex.h"
+#include "CountryTextScanner.h"
 #include "ICountryDatabase.h"
+#include "LoadStatistics.h"
+#include "StringArena.h"
 
 // Forward declarations for Wormhole namespace classes.
 namespace Wormhole
@@ -43,6 +52,10 @@ namespace EuropeanCountries
 
 	// Forward declarations for EuropeanCountries namespace classes.
 	class Country;
+	class CountryDatabaseObserver;
+	class CountryLoadJob;
+	class CountrySnapshot;
+	class IFileReader;
 
 	/**
 	 * @brief Handles read operation from files.
@@ -53,20 +66,90 @@ namespace EuropeanCountries
 	public:
 		/**
 		 * Constructor.
+		 * Data files will be read directly from the LocalFiles.bin resource.
 		 */
 		DatabaseManager();
 
+		/**
+		 * Constructor.
+		 * Data files will be read using a given file reader. Files from
+		 * LocalFiles.bin will not be extracted.
+		 * @param fileReader Used to read the data files.
+		 * Its ownership is NOT passed to the database.
+		 */
+		DatabaseManager(IFileReader& fileReader);
+
 		/**
 		 * Destructor.
 		 */
 		~DatabaseManager();
 
 		/**
-		 * Extract files from LocalFiles.bin(if needed) and read country data.
+		 * Read country data from the LocalFiles.bin resource.
+		 * If LocalFiles.bin did not change since the last launch, data is
+		 * restored from the cache file written by the previous launch.
+		 * Only the summary fields are read, detail fields are read by
+		 * loadCountryDetails().
 		 * This operation is synchronous and it takes time.
 		 */
 		void readDataFromFiles();
 
+		/**
+		 * Start reading country data from the LocalFiles.bin resource.
+		 * Previously read data is removed. Only the CountryTable file is read,
+		 * country files are read by continueLoading().
+		 * If LocalFiles.bin did not change since the last launch, data is
+		 * restored from the cache file at once and no loading remains.
+		 */
+		void beginLoading();
+
+		/**
+		 * Read the next country files listed in the CountryTable file.
+		 * Files are read in load jobs of mLoadJobSize files, until the given
+		 * time is spent. At least one job is run. Jobs are merged in
+		 * CountryTable order, so the ids do not depend on the job size.
+		 * @param maxTime Time after which no new job is started, in
+		 * milliseconds.
+		 * @return true if files remain to be read, false otherwise.
+		 */
+		bool continueLoading(const int maxTime);
+
+		/**
+		 * Check if country files remain to be read by continueLoading().
+		 * @return true if loading is not finished, false otherwise.
+		 */
+		bool isLoading() const;
+
+		/**
+		 * Get the number of CountryTable files already read.
+		 * @return Number of files.
+		 */
+		int countLoadedFiles() const;
+
+		/**
+		 * Get the number of files listed in the CountryTable file.
+		 * @return Number of files, zero if data was restored from the cache.
+		 */
+		int countFilesToLoad() const;
+
+		/**
+		 * Read country data from a snapshot image created by writeSnapshot().
+		 * Previously read data is removed.
+		 * @param filePath Path of the snapshot file.
+		 * @return true if the data was read, false otherwise.
+		 */
+		bool readDataFromSnapshot(const MAUtil::String& filePath);
+
+		/**
+		 * Write all country data to a snapshot image.
+		 * @param filePath Path of the snapshot file.
+		 * @param checksum Value saved in the snapshot header.
+		 * @return true if the snapshot was written, false otherwise.
+		 */
+		bool writeSnapshot(
+			const MAUtil::String& filePath,
+			const int checksum = 0);
+
 		/**
 		 * Get the number of countries stored in database.
 		 * @return Number of countries.
@@ -89,8 +172,193 @@ namespace EuropeanCountries
 		 */
 		virtual Country* getCountryByIndex(const int index);
 
+		/**
+		 * Get a country for a given name, e.g. "Bosnia and Herzegovina".
+		 * @param name Given name. Case is ignored for ASCII letters.
+		 * @return Country with given name if it exists, otherwise NULL.
+		 * The ownership of the result is NOT passed to the caller.
+		 */
+		virtual Country* getCountryByName(const MAUtil::String& name);
+
+		/**
+		 * Get a country for a given capital, e.g. "Sarajevo".
+		 * @param capital Given capital. Case is ignored for ASCII letters.
+		 * @return Country with given capital if it exists, otherwise NULL.
+		 * The ownership of the result is NOT passed to the caller.
+		 */
+		virtual Country* getCountryByCapital(const MAUtil::String& capital);
+
+		/**
+		 * Get a country for a given file name from the CountryTable file,
+		 * e.g. "Bosnia_and_Herzegovina".
+		 * @param fileName Given file name. Case is ignored for ASCII letters.
+		 * @return Country read from given file if it exists, otherwise NULL.
+		 * The ownership of the result is NOT passed to the caller.
+		 */
+		virtual Country* getCountryByFileName(const MAUtil::String& fileName);
+
+		/**
+		 * Load the detail fields(languages and government) of a given country.
+		 * Only a few recently displayed countries keep their details loaded.
+		 * @param country Country that will be displayed.
+		 * @return true if the details are loaded, false otherwise.
+		 */
+		virtual bool loadCountryDetails(Country& country);
+
+		/**
+		 * Get the table with the fields used by the countries list.
+		 * Reading the list fields from it is faster than reading them
+		 * from the Country objects.
+		 * @return The summary table. Row indexes are country ids.
+		 */
+		virtual const CountrySummaryTable& getSummaryTable();
+
+		/**
+		 * Get the country ids sorted by a given field.
+		 * The order is computed once and reused until the data changes.
+		 * @param field Field used to sort.
+		 * @param ascending If true the smallest value comes first.
+		 * @return Sorted country ids. It is valid until the data changes.
+		 */
+		virtual const MAUtil::Vector<int>& getSortedCountryIDs(
+			const CountrySortField field,
+			const bool ascending);
+
+		/**
+		 * Find the countries whose name or capital contains a word that
+		 * starts with a given text. Case is ignored for ASCII letters.
+		 * Searching for a text that extends the previous one(as the user
+		 * types) only checks the previous results.
+		 * @param text Text typed by the user.
+		 * @param order Country ids in list order, e.g. from
+		 * getSortedCountryIDs(). The position of each id is computed once
+		 * for an array returned by getSortedCountryIDs(), and by every call
+		 * for any other array.
+		 * @param outMatches Will contain a match for each found country,
+		 * in the order given by param order.
+		 */
+		virtual void searchCountries(
+			const MAUtil::String& text,
+			const MAUtil::Vector<int>& order,
+			MAUtil::Vector<CountryMatch>& outMatches);
+
+		/**
+		 * Find the countries whose name or capital contains a given text
+		 * with a few typing mistakes, e.g. "Chech Republic".
+		 * @param text Text typed by the user. Case is ignored for ASCII
+		 * letters.
+		 * @param maxResults Maximum number of returned countries.
+		 * @param outMatches Will contain the found countries, the best
+		 * match first.
+		 */
+		virtual void findCountriesFuzzy(
+			const MAUtil::String& text,
+			const int maxResults,
+			MAUtil::Vector<CountryFuzzyMatch>& outMatches);
+
+		/**
+		 * Search the languages and government texts of all countries.
+		 * Countries that contain any of the query words are ranked by
+		 * relevance. Words between double quotes form a phrase that must
+		 * be found as it is, e.g. "parliamentary republic".
+		 * @param query Words to search. Case is ignored for ASCII letters.
+		 * @param outMatches Will contain the found countries, the most
+		 * relevant first.
+		 * The index is built by the first search, so the detail fields are
+		 * not parsed at startup.
+		 */
+		virtual void searchCountryText(
+			const MAUtil::String& query,
+			MAUtil::Vector<CountryTextMatch>& outMatches);
+
+		/**
+		 * Find all occurrences of a text in the country fields(name,
+		 * capital, population, area, languages and government).
+		 * Unlike searchCountryText() it finds any part of a word,
+		 * punctuation and numbers. Case is not ignored.
+		 * @param text Text to search.
+		 * @param outOccurrences Will contain the occurrences in country
+		 * id order.
+		 * The texts are copied in one buffer by the first scan.
+		 */
+		virtual void scanCountryText(
+			const MAUtil::String& text,
+			MAUtil::Vector<CountryTextOccurrence>& outOccurrences);
+
+		/**
+		 * Add an observer that will be notified when countries are added
+		 * or removed, e.g. while the database is loading.
+		 * @param observer The observer. Its ownership is NOT passed to the
+		 * database.
+		 */
+		virtual void addObserver(CountryDatabaseObserver& observer);
+
+		/**
+		 * Remove an observer added by addObserver().
+		 * @param observer The observer.
+		 */
+		virtual void removeObserver(CountryDatabaseObserver& observer);
+
+		/**
+		 * Get the measurements collected by the last readDataFromFiles() call.
+		 * @return Load statistics.
+		 */
+		const LoadStatistics& getLoadStatistics() const;
+
+		/**
+		 * Enable or disable the cache file used on warm start.
+		 * The cache is enabled by default only when reading from LocalFiles.bin.
+		 * @param enabled If true data is restored from and saved to the cache.
+		 */
+		void setCacheEnabled(const bool enabled);
+
+		/**
+		 * Set the number of country files read by each load job.
+		 * Results do not depend on it, only the load time and the memory
+		 * used while loading do.
+		 * @param countFiles Number of files. Values smaller than one are
+		 * replaced with one.
+		 */
+		void setLoadJobSize(const int countFiles);
+
 	private:
 
+		/**
+		 * Delete all countries and clear data read from files.
+		 * Observers are notified if countries were removed.
+		 */
+		void clearData();
+
+		/**
+		 * Create countries from a loaded snapshot image.
+		 * Previously read data is removed. The image is moved into the string
+		 * arena, so texts are not copied. Observers are notified that
+		 * countries were added and that loading finished.
+		 * @param snapshot Snapshot that contains the data.
+		 */
+		void createCountriesFromSnapshot(CountrySnapshot& snapshot);
+
+		/**
+		 * Build the full text index and the text scanner from the fields
+		 * of all countries.
+		 * Details that are not loaded are read from the country files.
+		 */
+		void buildTextIndexes();
+
+		/**
+		 * Restore data from the cache file.
+		 * @param checksum Checksum of LocalFiles.bin. The cache is used only
+		 * if it was written for the same checksum.
+		 * @return true if data was restored, false otherwise.
+		 */
+		bool readCacheFile(const int checksum);
+
+		/**
+		 * Write all country data to the cache file.
+		 * @param checksum Checksum of LocalFiles.bin used to read the data.
+		 */
+		void writeCacheFile(const int checksum);
+
 		/**
 		 * Reads the CountryTable file.
 		 * Data will be written into mCountryFileNames.
@@ -98,21 +366,63 @@ namespace EuropeanCountries
 		void readCountryTableFile();
 
 		/**
-		 * Read all country files specified in the CountryTable file.
-		 * Data will be written into mCountries.
+		 * Called after the last country file was read.
+		 * The cache file is written if it is enabled and observers are
+		 * notified.
+		 */
+		void finishLoading();
+
+		/**
+		 * Read and parse the files of a load job.
+		 * A file that cannot be read or parsed is reported and skipped.
+		 * @param job Job to run.
+		 */
+		void runLoadJob(CountryLoadJob& job);
+
+		/**
+		 * Add the countries of a load job that was run.
+		 * The job numbers the countries by CountryTable index; they are
+		 * renumbered so that ids stay the indexes in mCountriesArray when
+		 * files were skipped.
+		 * @param job Job that contains the countries. It is left empty.
+		 */
+		void mergeLoadJob(CountryLoadJob& job);
+
+		/**
+		 * Notify the observers that countries were added.
+		 * @param firstID Id of the first added country.
+		 * @param countCountries Number of added countries.
+		 */
+		void notifyCountriesAdded(const int firstID, const int countCountries);
+
+		/**
+		 * Notify the observers that all countries were removed.
+		 */
+		void notifyCountriesRemoved();
+
+		/**
+		 * Notify the observers that the database is fully loaded.
+		 */
+		void notifyLoadingFinished();
+
+		/**
+		 * Get the reader used for the data files.
+		 * The LocalFiles.bin reader is created by the first call.
+		 * @return The file reader.
 		 */
-		void readAllCountryFiles();
+		IFileReader& getFileReader();
 
 		/**
-		 * Read a given country file.
-		 * Data will be added into mCountries.
-		 * @param countryFileName File name to read.
+		 * Replace the LocalFiles.bin reader with one that reads files
+		 * extracted to the local file system.
+		 * Used only if the bundle cannot be read in place.
 		 */
-		void readCountryFile(MAUtil::String& countryFileName);
+		void useExtractedFiles();
 
 		/**
 		 * Extract LocalFile.bin to the local file system.
-		 * Files will be extracted only if the checksum does not match.
+		 * Files will be extracted only if the checksum does not match, and
+		 * then only new or changed files are written.
 		 */
 		void extractLocalFiles();
 
@@ -130,10 +440,68 @@ namespace EuropeanCountries
 
 	private:
 		/**
-		 * Used to extract LocalFiles.bin
+		 * Used to extract LocalFiles.bin and to get its checksum.
 		 */
 		Wormhole::FileUtil* mFileUtil;
 
+		/**
+		 * Used to read the CountryTable file and the country files.
+		 */
+		IFileReader* mFileReader;
+
+		/**
+		 * True if mFileReader was created by the database and must be
+		 * deleted by it.
+		 */
+		bool mOwnsFileReader;
+
+		/**
+		 * True if files are read from the LocalFiles.bin resource.
+		 */
+		bool mReadFromBundle;
+
+		/**
+		 * True if LocalFiles.bin could not be read in place and files are
+		 * read from the local file system.
+		 */
+		bool mUsesExtractedFiles;
+
+		/**
+		 * True if data is restored from and saved to the cache file.
+		 */
+		bool mCacheEnabled;
+
+		/**
+		 * Number of country files read by each load job.
+		 */
+		int mLoadJobSize;
+
+		/**
+		 * True if country files remain to be read by continueLoading().
+		 */
+		bool mIsLoading;
+
+		/**
+		 * Index in mCountryFileNames of the next file to read.
+		 */
+		int mNextFileIndex;
+
+		/**
+		 * Checksum of LocalFiles.bin saved in the cache file when loading
+		 * finishes. Zero if no cache file is written.
+		 */
+		int mLoadChecksum;
+
+		/**
+		 * Stores the texts of the summary fields of all countries.
+		 */
+		StringArena mStringArena;
+
+		/**
+		 * Used to parse the CountryTable file and the country files.
+		 */
+		CountryParser mCountryParser;
+
 		/**
 		 * Holds data from CountryTable file.
 		 */
@@ -141,16 +509,62 @@ namespace EuropeanCountries
 
 		/**
 		 * Holds data from all country files.
-		 * Int value represents the key(coutry's id value).
+		 * A country is stored at the index given by its id.
 		 */
-		MAUtil::Map<int, Country*> mCountriesMap;
+		MAUtil::Vector<Country*> mCountriesArray;
 
 		/**
-		 * Holds data from all country files.
-		 * Contains same data as mCountriesMap, but for performance reasons data
-		 * will be stored in vector too.
+		 * Fields used by the countries list, stored in columns.
+		 * Has a row for each country from mCountriesArray.
 		 */
-		MAUtil::Vector<Country*> mCountriesArray;
+		CountrySummaryTable mSummaryTable;
+
+		/**
+		 * Hash tables over the names, capitals and file names of the
+		 * countries from mCountriesArray.
+		 */
+		CountryKeyIndex mKeyIndex;
+
+		/**
+		 * Sorted orders of the rows from mSummaryTable.
+		 */
+		CountrySortIndex mSortIndex;
+
+		/**
+		 * Prefix index over the names and capitals from mSummaryTable.
+		 */
+		CountrySearchIndex mSearchIndex;
+
+		/**
+		 * Trigram index over the names and capitals from mSummaryTable.
+		 */
+		CountryFuzzyIndex mFuzzyIndex;
+
+		/**
+		 * Full text index over the detail fields.
+		 */
+		CountryTextIndex mTextIndex;
+
+		/**
+		 * All country texts in one buffer, used by scanCountryText().
+		 */
+		CountryTextScanner mTextScanner;
+
+		/**
+		 * Countries that have their detail fields loaded, the least
+		 * recently displayed first.
+		 */
+		MAUtil::Vector<Country*> mDetailsCache;
+
+		/**
+		 * Measurements collected by the last load operation.
+		 */
+		LoadStatistics mLoadStatistics;
+
+		/**
+		 * Notified when countries are added or removed.
+		 */
+		MAUtil::Vector<CountryDatabaseObserver*> mObservers;
 
 	}; // end of DatabaseManager
 
@@ -26,10 +26,20 @@
 #ifndef EC_I_COUNTRY_DATABASE_H_
 #define EC_I_COUNTRY_DATABASE_H_
 
+#include <MAUtil/Vector.h>
+
+#include "CountryFuzzyIndex.h"
+#include "CountrySearchIndex.h"
+#include "CountrySortIndex.h"
+#include "CountryTextIndex.h"
+#include "CountryTextScanner.h"
+
 namespace EuropeanCountries
 {
 	// Forward declaration.
 	class Country;
+	class CountryDatabaseObserver;
+	class CountrySummaryTable;
 
 	/**
 	 * @brief Interface to database manager used to read data from JSON files.
@@ -59,6 +69,131 @@ namespace EuropeanCountries
 		 */
 		virtual Country* getCountryByIndex(const int index) = 0;
 
+		/**
+		 * Get a country for a given name, e.g. "Bosnia and Herzegovina".
+		 * @param name Given name. Case is ignored for ASCII letters.
+		 * @return Country with given name if it exists, otherwise NULL.
+		 * The ownership of the result is NOT passed to the caller.
+		 */
+		virtual Country* getCountryByName(const MAUtil::String& name) = 0;
+
+		/**
+		 * Get a country for a given capital, e.g. "Sarajevo".
+		 * @param capital Given capital. Case is ignored for ASCII letters.
+		 * @return Country with given capital if it exists, otherwise NULL.
+		 * The ownership of the result is NOT passed to the caller.
+		 */
+		virtual Country* getCountryByCapital(const MAUtil::String& capital) = 0;
+
+		/**
+		 * Get a country for a given file name from the CountryTable file,
+		 * e.g. "Bosnia_and_Herzegovina".
+		 * @param fileName Given file name. Case is ignored for ASCII letters.
+		 * @return Country read from given file if it exists, otherwise NULL.
+		 * The ownership of the result is NOT passed to the caller.
+		 */
+		virtual Country* getCountryByFileName(const MAUtil::String& fileName) = 0;
+
+		/**
+		 * Load the detail fields(languages and government) of a given country.
+		 * They are not loaded with the other fields to keep the start up
+		 * fast and the memory usage low.
+		 * @param country Country that will be displayed.
+		 * @return true if the details are loaded, false otherwise.
+		 */
+		virtual bool loadCountryDetails(Country& country) = 0;
+
+		/**
+		 * Get the table with the fields used by the countries list.
+		 * Reading the list fields from it is faster than reading them
+		 * from the Country objects.
+		 * @return The summary table. Row indexes are country ids.
+		 */
+		virtual const CountrySummaryTable& getSummaryTable() = 0;
+
+		/**
+		 * Get the country ids sorted by a given field.
+		 * The order is computed once and reused until the data changes.
+		 * @param field Field used to sort.
+		 * @param ascending If true the smallest value comes first.
+		 * @return Sorted country ids. It is valid until the data changes.
+		 */
+		virtual const MAUtil::Vector<int>& getSortedCountryIDs(
+			const CountrySortField field,
+			const bool ascending) = 0;
+
+		/**
+		 * Find the countries whose name or capital contains a word that
+		 * starts with a given text. Case is ignored for ASCII letters.
+		 * Searching for a text that extends the previous one(as the user
+		 * types) only checks the previous results.
+		 * @param text Text typed by the user.
+		 * @param order Country ids in list order, e.g. from
+		 * getSortedCountryIDs(). The position of each id is computed once
+		 * for an array returned by getSortedCountryIDs(), and by every call
+		 * for any other array.
+		 * @param outMatches Will contain a match for each found country,
+		 * in the order given by param order.
+		 */
+		virtual void searchCountries(
+			const MAUtil::String& text,
+			const MAUtil::Vector<int>& order,
+			MAUtil::Vector<CountryMatch>& outMatches) = 0;
+
+		/**
+		 * Find the countries whose name or capital contains a given text
+		 * with a few typing mistakes, e.g. "Chech Republic".
+		 * @param text Text typed by the user. Case is ignored for ASCII
+		 * letters.
+		 * @param maxResults Maximum number of returned countries.
+		 * @param outMatches Will contain the found countries, the best
+		 * match first.
+		 */
+		virtual void findCountriesFuzzy(
+			const MAUtil::String& text,
+			const int maxResults,
+			MAUtil::Vector<CountryFuzzyMatch>& outMatches) = 0;
+
+		/**
+		 * Search the languages and government texts of all countries.
+		 * Countries that contain any of the query words are ranked by
+		 * relevance. Words between double quotes form a phrase that must
+		 * be found as it is, e.g. "parliamentary republic".
+		 * @param query Words to search. Case is ignored for ASCII letters.
+		 * @param outMatches Will contain the found countries, the most
+		 * relevant first.
+		 */
+		virtual void searchCountryText(
+			const MAUtil::String& query,
+			MAUtil::Vector<CountryTextMatch>& outMatches) = 0;
+
+		/**
+		 * Find all occurrences of a text in the country fields(name,
+		 * capital, population, area, languages and government).
+		 * Unlike searchCountryText() it finds any part of a word,
+		 * punctuation and numbers. Case is not ignored.
+		 * @param text Text to search.
+		 * @param outOccurrences Will contain the occurrences in country
+		 * id order.
+		 */
+		virtual void scanCountryText(
+			const MAUtil::String& text,
+			MAUtil::Vector<CountryTextOccurrence>& outOccurrences) = 0;
+
+		/**
+		 * Add an observer that will be notified when countries are added
+		 * or removed, e.g. while the database is loading.
+		 * @param observer The observer. Its ownership is NOT passed to the
+		 * database.
+		 */
+		virtual void addObserver(CountryDatabaseObserver& observer) = 0;
+
+		/**
+		 * Remove an observer added by addObserver().
+		 * @param observer The observer.
+		 */
+		virtual void removeObserver(CountryDatabaseObserver& observer) = 0;
+
 	}; // end of ICountryDatabase
 
 } // end of EuropeanCountries
@@ -0,0 +1,104 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file IFileReader.h
+ * @author Bogdan Iusco
+ *
+ * @brief Interface used by the database to read the content of data files.
+ */
+
+#ifndef EC_I_FILE_READER_H_
+#define EC_I_FILE_READER_H_
+
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Receives the files read by IFileReader::readTextFromFiles().
+	 */
+	class IFileBatchListener
+	{
+	public:
+		/**
+		 * Destructor.
+		 */
+		virtual ~IFileBatchListener() {};
+
+		/**
+		 * Called after a file of the batch was read.
+		 * @param index Index of the file in the file names array.
+		 * @param content File content, followed by a null character. It is
+		 * NULL if the file could not be read. It is valid only during
+		 * this call.
+		 * @param size Content size in bytes, zero if the file could not
+		 * be read.
+		 */
+		virtual void fileRead(
+			const int index,
+			const char* content,
+			const int size) = 0;
+
+	}; // end of IFileBatchListener
+
+	/**
+	 * @brief Interface used by the database to read data files.
+	 * It hides the place where files are stored, so the database does not
+	 * depend on the file system used by the platform.
+	 */
+	class IFileReader
+	{
+	public:
+		/**
+		 * Destructor.
+		 */
+		virtual ~IFileReader() {};
+
+		/**
+		 * Read the content of a given data file.
+		 * @param fileName Name of the file to read(e.g. "CountryTable").
+		 * @param outText Will contain the file content.
+		 * @return true if the file was read, false otherwise.
+		 */
+		virtual bool readTextFromFile(
+			const MAUtil::String& fileName,
+			MAUtil::String& outText) = 0;
+
+		/**
+		 * Read the content of several data files. Each file is passed to
+		 * the listener as soon as it is read, so the reader can use the
+		 * same buffer for all files.
+		 * @param fileNames Names of the files.
+		 * @param firstIndex Index of the first file to read.
+		 * @param endIndex Index after the last file to read.
+		 * @param listener Receives the files, in array order.
+		 */
+		virtual void readTextFromFiles(
+			const MAUtil::Vector<MAUtil::String>& fileNames,
+			const int firstIndex,
+			const int endIndex,
+			IFileBatchListener& listener) = 0;
+
+	}; // end of IFileReader
+
+} // end of EuropeanCountries
+
+#endif /* EC_I_FILE_READER_H_ */
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file LoadStatistics.h
+ * @author Bogdan Iusco
+ *
+ * @brief Time and size measurements collected while loading the database.
+ */
+
+#ifndef EC_LOAD_STATISTICS_H_
+#define EC_LOAD_STATISTICS_H_
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Measurements collected by DatabaseManager::readDataFromFiles().
+	 * All times are in milliseconds.
+	 */
+	struct LoadStatistics
+	{
+		/**
+		 * Constructor.
+		 */
+		LoadStatistics()
+		{
+			this->reset();
+		}
+
+		/**
+		 * Set all values to zero.
+		 */
+		void reset()
+		{
+			extractTime = 0;
+			countryTableTime = 0;
+			countryFilesTime = 0;
+			totalTime = 0;
+			countCountries = 0;
+			bytesRead = 0;
+			loadedFromCache = false;
+		}
+
+		/**
+		 * Time spent extracting LocalFiles.bin. Zero when the data files are
+		 * read directly from the resource.
+		 */
+		int extractTime;
+
+		/**
+		 * Time spent reading and parsing the CountryTable file.
+		 */
+		int countryTableTime;
+
+		/**
+		 * Time spent reading and parsing all country files.
+		 */
+		int countryFilesTime;
+
+		/**
+		 * Time spent by the whole load operation.
+		 */
+		int totalTime;
+
+		/**
+		 * Number of loaded countries.
+		 */
+		int countCountries;
+
+		/**
+		 * Number of bytes read from the CountryTable file and country files.
+		 * A double, so sums over several loads of a large dataset do not
+		 * overflow.
+		 */
+		double bytesRead;
+
+		/**
+		 * True if data was restored from the cache file instead of being
+		 * read from the data files.
+		 */
+		bool loadedFromCache;
+
+	}; // end of LoadStatistics
+
+} // end of EuropeanCountries
+
+#endif /* EC_LOAD_STATISTICS_H_ */
@@ -0,0 +1,134 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file LocalFileReader.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Reads data files from a directory of the local file system.
+ */
+
+#include <maapi.h>
+#include <Wormhole/FileUtil.h>
+
+#include "LocalFileReader.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Constructor.
+	 * @param directoryPath Path to the directory that contains the files.
+	 * Must end with a path separator.
+	 */
+	LocalFileReader::LocalFileReader(const MAUtil::String& directoryPath):
+		mFileUtil(NULL),
+		mDirectoryPath(directoryPath)
+	{
+		mFileUtil = new Wormhole::FileUtil();
+	}
+
+	/**
+	 * Destructor.
+	 */
+	LocalFileReader::~LocalFileReader()
+	{
+		delete mFileUtil;
+	}
+
+	/**
+	 * Read the content of a given data file.
+	 * From IFileReader.
+	 * @param fileName Name of the file to read(e.g. "CountryTable").
+	 * @param outText Will contain the file content.
+	 * @return true if the file was read, false otherwise.
+	 */
+	bool LocalFileReader::readTextFromFile(
+		const MAUtil::String& fileName,
+		MAUtil::String& outText)
+	{
+		MAUtil::String filePath = mDirectoryPath + fileName;
+		return mFileUtil->readTextFromFile(filePath, outText);
+	}
+
+	/**
+	 * Read the content of several data files. Each file is passed to
+	 * the listener as soon as it is read, so the reader can use the
+	 * same buffer for all files.
+	 * From IFileReader.
+	 * @param fileNames Names of the files.
+	 * @param firstIndex Index of the first file to read.
+	 * @param endIndex Index after the last file to read.
+	 * @param listener Receives the files, in array order.
+	 */
+	void LocalFileReader::readTextFromFiles(
+		const MAUtil::Vector<MAUtil::String>& fileNames,
+		const int firstIndex,
+		const int endIndex,
+		IFileBatchListener& listener)
+	{
+		// The path and the content buffers are reused for all files, and
+		// the content is not copied to a string.
+		int directoryLength = mDirectoryPath.length();
+		MAUtil::String filePath = mDirectoryPath;
+		MAUtil::String content;
+		for (int index = firstIndex; index < endIndex; index++)
+		{
+			filePath.resize(directoryLength);
+			filePath += fileNames[index];
+
+			// maFileSize() fails for a missing file, so maFileExists()
+			// is not called.
+			int size = -1;
+			MAHandle file = maFileOpen(filePath.c_str(), MA_ACCESS_READ);
+			if (file >= 0)
+			{
+				size = maFileSize(file);
+				if (size >= 0)
+				{
+					content.resize(size);
+					if (size > 0 &&
+						maFileRead(file, content.pointer(), size) != 0)
+					{
+						size = -1;
+					}
+				}
+				maFileClose(file);
+			}
+
+			if (size >= 0)
+			{
+				listener.fileRead(index, content.c_str(), size);
+			}
+			else
+			{
+				listener.fileRead(index, NULL, 0);
+			}
+		}
+	}
+
+	/**
+	 * Get the directory used to read files.
+	 * @return Directory path.
+	 */
+	const MAUtil::String& LocalFileReader::getDirectoryPath() const
+	{
+		return mDirectoryPath;
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,109 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file LocalFileReader.h
+ * @author Bogdan Iusco
+ *
+ * @brief Reads data files from a directory of the local file system.
+ */
+
+#ifndef EC_LOCAL_FILE_READER_H_
+#define EC_LOCAL_FILE_READER_H_
+
+#include <MAUtil/String.h>
+
+#include "IFileReader.h"
+
+// Forward declarations for Wormhole namespace classes.
+namespace Wormhole
+{
+	class FileUtil;
+}
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Reads data files from a directory of the local file system.
+	 */
+	class LocalFileReader:
+		public IFileReader
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param directoryPath Path to the directory that contains the files.
+		 * Must end with a path separator.
+		 */
+		LocalFileReader(const MAUtil::String& directoryPath);
+
+		/**
+		 * Destructor.
+		 */
+		virtual ~LocalFileReader();
+
+		/**
+		 * Read the content of a given data file.
+		 * From IFileReader.
+		 * @param fileName Name of the file to read(e.g. "CountryTable").
+		 * @param outText Will contain the file content.
+		 * @return true if the file was read, false otherwise.
+		 */
+		virtual bool readTextFromFile(
+			const MAUtil::String& fileName,
+			MAUtil::String& outText);
+
+		/**
+		 * Read the content of several data files. Each file is passed to
+		 * the listener as soon as it is read, so the reader can use the
+		 * same buffer for all files.
+		 * From IFileReader.
+		 * @param fileNames Names of the files.
+		 * @param firstIndex Index of the first file to read.
+		 * @param endIndex Index after the last file to read.
+		 * @param listener Receives the files, in array order.
+		 */
+		virtual void readTextFromFiles(
+			const MAUtil::Vector<MAUtil::String>& fileNames,
+			const int firstIndex,
+			const int endIndex,
+			IFileBatchListener& listener);
+
+		/**
+		 * Get the directory used to read files.
+		 * @return Directory path.
+		 */
+		const MAUtil::String& getDirectoryPath() const;
+
+	private:
+		/**
+		 * Used to read files.
+		 */
+		Wormhole::FileUtil* mFileUtil;
+
+		/**
+		 * Path to the directory that contains the files.
+		 */
+		MAUtil::String mDirectoryPath;
+
+	}; // end of LocalFileReader
+
+} // end of EuropeanCountries
+
+#endif /* EC_LOCAL_FILE_READER_H_ */
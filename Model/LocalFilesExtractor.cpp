@@ -0,0 +1,240 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file LocalFilesExtractor.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Extracts only the changed files from LocalFiles.bin.
+ */
+
+#define MANIFEST_FILE_NAME "ECManifest"
+#define COUNTRY_TABLE_FILE_NAME "CountryTable"
+#define MANIFEST_LINE_BUF_SIZE 16
+
+#include <conprint.h>
+#include <mastdlib.h>
+
+#include "BundleFileReader.h"
+#include "CountryParser.h"
+#include "LocalFilesExtractor.h"
+#include "ModelUtils.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Constructor.
+	 * @param bundle Handle to the bundle resource.
+	 * @param destinationPath Directory where files are extracted.
+	 * Must end with a path separator.
+	 */
+	LocalFilesExtractor::LocalFilesExtractor(
+		MAHandle bundle,
+		const MAUtil::String& destinationPath):
+		mBundle(bundle),
+		mDestinationPath(destinationPath),
+		mCountWrittenFiles(0),
+		mCountDeletedFiles(0)
+	{
+	}
+
+	/**
+	 * Extract new and changed files and delete removed files.
+	 * The bundle must contain a CountryTable file that lists all
+	 * country files.
+	 * @return true on success, false otherwise.
+	 */
+	bool LocalFilesExtractor::extract()
+	{
+		mCountWrittenFiles = 0;
+		mCountDeletedFiles = 0;
+
+		BundleFileReader bundleReader(mBundle);
+
+		// Get the list of files contained by the bundle.
+		MAUtil::String countryTable;
+		if (!bundleReader.readTextFromFile(COUNTRY_TABLE_FILE_NAME, countryTable))
+		{
+			printf("Cannot read CountryTable from bundle");
+			return false;
+		}
+		MAUtil::Vector<MAUtil::String> fileNames;
+		StringArena stringArena;
+		CountryParser parser(stringArena);
+		if (!parser.parseCountryTable(
+			countryTable.c_str(), countryTable.size(), fileNames))
+		{
+			return false;
+		}
+		fileNames.add(COUNTRY_TABLE_FILE_NAME);
+
+		MAUtil::Map<MAUtil::String, unsigned int> oldDigests;
+		this->readManifest(oldDigests);
+
+		// Write files that are new or changed.
+		bool success = true;
+		MAUtil::Vector<unsigned int> digests;
+		for (int index = 0; index < fileNames.size(); index++)
+		{
+			const MAUtil::String& fileName = fileNames[index];
+			MAUtil::String content;
+			if (!bundleReader.readTextFromFile(fileName, content))
+			{
+				printf("Cannot read %s from bundle", fileName.c_str());
+				success = false;
+				digests.add(0);
+				continue;
+			}
+
+			unsigned int digest = hashData(content.c_str(), content.size());
+			digests.add(digest);
+
+			MAUtil::String filePath = mDestinationPath + fileName;
+			MAUtil::Map<MAUtil::String, unsigned int>::Iterator it =
+				oldDigests.find(fileName);
+			bool unchanged = it != oldDigests.end() && it->second == digest;
+			if (it != oldDigests.end())
+			{
+				oldDigests.erase(fileName);
+			}
+			if (unchanged && fileExists(filePath))
+			{
+				continue;
+			}
+
+			if (writeBinaryFile(filePath, content.c_str(), content.size()))
+			{
+				mCountWrittenFiles++;
+			}
+			else
+			{
+				printf("Cannot write %s", filePath.c_str());
+				success = false;
+			}
+		}
+
+		// Files left in the old manifest were removed from the bundle.
+		MAUtil::Map<MAUtil::String, unsigned int>::Iterator it;
+		for (it = oldDigests.begin(); it != oldDigests.end(); it++)
+		{
+			if (deleteFile(mDestinationPath + it->first))
+			{
+				mCountDeletedFiles++;
+			}
+		}
+
+		// A failed extraction must not be trusted next time.
+		if (success)
+		{
+			success = this->writeManifest(fileNames, digests);
+		}
+		else
+		{
+			deleteFile(mDestinationPath + MANIFEST_FILE_NAME);
+		}
+		return success;
+	}
+
+	/**
+	 * Get the number of files written by the last extract() call.
+	 * @return Number of files.
+	 */
+	int LocalFilesExtractor::countWrittenFiles() const
+	{
+		return mCountWrittenFiles;
+	}
+
+	/**
+	 * Get the number of files deleted by the last extract() call.
+	 * @return Number of files.
+	 */
+	int LocalFilesExtractor::countDeletedFiles() const
+	{
+		return mCountDeletedFiles;
+	}
+
+	/**
+	 * Read the manifest written by the previous extraction.
+	 * Each manifest line contains a hexadecimal digest and a file name,
+	 * separated by a space.
+	 * @param outDigests Will contain pairs of file name and digest.
+	 */
+	void LocalFilesExtractor::readManifest(
+		MAUtil::Map<MAUtil::String, unsigned int>& outDigests)
+	{
+		int size = 0;
+		char* data = readBinaryFile(mDestinationPath + MANIFEST_FILE_NAME, size);
+		if (!data)
+		{
+			return;
+		}
+
+		int lineStart = 0;
+		while (lineStart < size)
+		{
+			int lineEnd = lineStart;
+			while (lineEnd < size && data[lineEnd] != '\n')
+			{
+				lineEnd++;
+			}
+
+			int separator = lineStart;
+			while (separator < lineEnd && data[separator] != ' ')
+			{
+				separator++;
+			}
+
+			if (separator < lineEnd)
+			{
+				data[separator] = '\0';
+				unsigned int digest =
+					(unsigned int) strtoul(data + lineStart, NULL, 16);
+				MAUtil::String fileName(
+					data + separator + 1, lineEnd - separator - 1);
+				outDigests.insert(fileName, digest);
+			}
+			lineStart = lineEnd + 1;
+		}
+		free(data);
+	}
+
+	/**
+	 * Write the manifest for the current extraction.
+	 * @param fileNames Extracted file names.
+	 * @param digests Digest of each extracted file.
+	 * @return true on success, false otherwise.
+	 */
+	bool LocalFilesExtractor::writeManifest(
+		const MAUtil::Vector<MAUtil::String>& fileNames,
+		const MAUtil::Vector<unsigned int>& digests)
+	{
+		MAUtil::String manifest;
+		for (int index = 0; index < fileNames.size(); index++)
+		{
+			char digestBuf[MANIFEST_LINE_BUF_SIZE];
+			sprintf(digestBuf, "%08x ", digests[index]);
+			manifest += digestBuf;
+			manifest += fileNames[index];
+			manifest += "\n";
+		}
+		return writeBinaryFile(mDestinationPath + MANIFEST_FILE_NAME,
+			manifest.c_str(), manifest.size());
+	}
+
+} // end of EuropeanCountries
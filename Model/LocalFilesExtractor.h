@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file LocalFilesExtractor.h
+ * @author Bogdan Iusco
+ *
+ * @brief Extracts only the changed files from LocalFiles.bin.
+ */
+
+#ifndef EC_LOCAL_FILES_EXTRACTOR_H_
+#define EC_LOCAL_FILES_EXTRACTOR_H_
+
+#include <maapi.h>
+#include <MAUtil/Map.h>
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Incremental extraction of a file system bundle.
+	 * A manifest file with a digest for each extracted file is kept in the
+	 * destination directory. Only files that are new or whose digest changed
+	 * are written, and files removed from the bundle are deleted.
+	 */
+	class LocalFilesExtractor
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param bundle Handle to the bundle resource.
+		 * @param destinationPath Directory where files are extracted.
+		 * Must end with a path separator.
+		 */
+		LocalFilesExtractor(
+			MAHandle bundle,
+			const MAUtil::String& destinationPath);
+
+		/**
+		 * Extract new and changed files and delete removed files.
+		 * The bundle must contain a CountryTable file that lists all
+		 * country files.
+		 * @return true on success, false otherwise.
+		 */
+		bool extract();
+
+		/**
+		 * Get the number of files written by the last extract() call.
+		 * @return Number of files.
+		 */
+		int countWrittenFiles() const;
+
+		/**
+		 * Get the number of files deleted by the last extract() call.
+		 * @return Number of files.
+		 */
+		int countDeletedFiles() const;
+
+	private:
+		/**
+		 * Read the manifest written by the previous extraction.
+		 * @param outDigests Will contain pairs of file name and digest.
+		 */
+		void readManifest(MAUtil::Map<MAUtil::String, unsigned int>& outDigests);
+
+		/**
+		 * Write the manifest for the current extraction.
+		 * @param fileNames Extracted file names.
+		 * @param digests Digest of each extracted file.
+		 * @return true on success, false otherwise.
+		 */
+		bool writeManifest(
+			const MAUtil::Vector<MAUtil::String>& fileNames,
+			const MAUtil::Vector<unsigned int>& digests);
+
+	private:
+		/**
+		 * Handle to the bundle resource.
+		 */
+		MAHandle mBundle;
+
+		/**
+		 * Directory where files are extracted.
+		 */
+		MAUtil::String mDestinationPath;
+
+		/**
+		 * Number of files written by the last extraction.
+		 */
+		int mCountWrittenFiles;
+
+		/**
+		 * Number of files deleted by the last extraction.
+		 */
+		int mCountDeletedFiles;
+
+	}; // end of LocalFilesExtractor
+
+} // end of EuropeanCountries
+
+#endif /* EC_LOCAL_FILES_EXTRACTOR_H_ */
@@ -23,6 +23,8 @@
  * @brief Constants for model objects.
  */
 
+#include <mastdlib.h>
+
 #include "ModelUtils.h"
 
 namespace EuropeanCountries
@@ -44,4 +46,209 @@ namespace EuropeanCountries
 	const char* sCountryGovernmentKey = "Government";
 	const char* sCountryCapitalKey = "Capital";
 
+	/**
+	 * Compute a 32 bit FNV-1a hash for a given buffer.
+	 * @param data Data to hash.
+	 * @param length Data length in bytes.
+	 * @param ignoreCase If true ASCII letters are hashed as lower case.
+	 * @return Hash value.
+	 */
+	unsigned int hashData(
+		const char* data,
+		const int length,
+		const bool ignoreCase)
+	{
+		unsigned int hash = 2166136261u;
+		for (int i = 0; i < length; i++)
+		{
+			hash ^= ignoreCase ?
+				toLowerASCII(data[i]) : (unsigned char) data[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	/**
+	 * Parse a number written with thousands separators, such as
+	 * "81,799,600" or "42,894.8". Leading spaces are skipped.
+	 * @param text Text to parse. It does not need to be null terminated.
+	 * @param length Text length in bytes.
+	 * @param outValue Will contain the parsed value.
+	 * @return Number of characters used(including the skipped spaces), or
+	 * zero if the text does not start with a number.
+	 */
+	int parseNumber(const char* text, const int length, double& outValue)
+	{
+		int position = 0;
+		while (position < length && text[position] == ' ')
+		{
+			position++;
+		}
+
+		// Integer part. Separators are accepted only between digits.
+		double value = 0;
+		int countDigits = 0;
+		while (position < length)
+		{
+			char c = text[position];
+			if (c >= '0' && c <= '9')
+			{
+				value = value * 10 + (c - '0');
+				countDigits++;
+			}
+			else if (c != ',' || countDigits == 0 ||
+				position + 1 >= length ||
+				text[position + 1] < '0' || text[position + 1] > '9')
+			{
+				break;
+			}
+			position++;
+		}
+		if (countDigits == 0)
+		{
+			return 0;
+		}
+
+		// Fractional part.
+		if (position + 1 < length && text[position] == '.' &&
+			text[position + 1] >= '0' && text[position + 1] <= '9')
+		{
+			position++;
+			double scale = 0.1;
+			while (position < length &&
+				text[position] >= '0' && text[position] <= '9')
+			{
+				value += (text[position] - '0') * scale;
+				scale /= 10;
+				position++;
+			}
+		}
+
+		outValue = value;
+		return position;
+	}
+
+	/**
+	 * Open a file for writing. The file is created if it does not exist,
+	 * otherwise its content is removed.
+	 * @param filePath Path of the file to open.
+	 * @return File handle, or a negative value on error.
+	 */
+	MAHandle openFileForWriting(const MAUtil::String& filePath)
+	{
+		MAHandle file = maFileOpen(filePath.c_str(), MA_ACCESS_READ_WRITE);
+		if (file < 0)
+		{
+			return file;
+		}
+
+		if (maFileExists(file))
+		{
+			maFileTruncate(file, 0);
+		}
+		else if (maFileCreate(file) < 0)
+		{
+			maFileClose(file);
+			return -1;
+		}
+		return file;
+	}
+
+	/**
+	 * Read the whole content of a file with a single read operation.
+	 * @param filePath Path of the file to read.
+	 * @param outSize Will contain the number of bytes read.
+	 * @return Buffer with file content allocated with malloc, or NULL if the
+	 * file could not be read. Its ownership is passed to the caller.
+	 */
+	char* readBinaryFile(const MAUtil::String& filePath, int& outSize)
+	{
+		outSize = 0;
+		MAHandle file = maFileOpen(filePath.c_str(), MA_ACCESS_READ);
+		if (file < 0)
+		{
+			return NULL;
+		}
+
+		char* buffer = NULL;
+		int size = maFileExists(file) ? maFileSize(file) : -1;
+		if (size > 0)
+		{
+			buffer = (char*) malloc(size);
+			if (buffer && maFileRead(file, buffer, size) != 0)
+			{
+				free(buffer);
+				buffer = NULL;
+			}
+		}
+		maFileClose(file);
+
+		if (buffer)
+		{
+			outSize = size;
+		}
+		return buffer;
+	}
+
+	/**
+	 * Check if a file exists.
+	 * @param filePath Path of the file.
+	 * @return true if the file exists, false otherwise.
+	 */
+	bool fileExists(const MAUtil::String& filePath)
+	{
+		MAHandle file = maFileOpen(filePath.c_str(), MA_ACCESS_READ);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		bool exists = maFileExists(file) > 0;
+		maFileClose(file);
+		return exists;
+	}
+
+	/**
+	 * Delete a file.
+	 * @param filePath Path of the file.
+	 * @return true if the file was deleted, false otherwise.
+	 */
+	bool deleteFile(const MAUtil::String& filePath)
+	{
+		MAHandle file = maFileOpen(filePath.c_str(), MA_ACCESS_READ_WRITE);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		// The handle stays open after the file is deleted.
+		bool deleted = maFileExists(file) && maFileDelete(file) == 0;
+		maFileClose(file);
+		return deleted;
+	}
+
+	/**
+	 * Write a buffer to a file with a single write operation.
+	 * Old file content is removed.
+	 * @param filePath Path of the file to write.
+	 * @param data Data to write.
+	 * @param size Number of bytes to write.
+	 * @return true on success, false otherwise.
+	 */
+	bool writeBinaryFile(
+		const MAUtil::String& filePath,
+		const void* data,
+		const int size)
+	{
+		MAHandle file = openFileForWriting(filePath);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		bool result = maFileWrite(file, data, size) == 0;
+		maFileClose(file);
+		return result;
+	}
+
 } // end of EuropeanCountries
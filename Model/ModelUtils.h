@@ -26,6 +26,10 @@
 #ifndef EC_MODEL_UTILS_H_
 #define EC_MODEL_UTILS_H_
 
+#include <maapi.h>
+#include <mastdlib.h>
+#include <MAUtil/String.h>
+
 namespace EuropeanCountries
 {
 
@@ -45,6 +49,250 @@ namespace EuropeanCountries
 	extern const char* sCountryGovernmentKey;
 	extern const char* sCountryCapitalKey;
 
+	/**
+	 * Compute a 32 bit FNV-1a hash for a given buffer.
+	 * @param data Data to hash.
+	 * @param length Data length in bytes.
+	 * @param ignoreCase If true ASCII letters are hashed as lower case.
+	 * @return Hash value.
+	 */
+	unsigned int hashData(
+		const char* data,
+		const int length,
+		const bool ignoreCase = false);
+
+	/**
+	 * Convert an ASCII letter to lower case. Other characters are
+	 * not changed.
+	 * @param c Character to convert.
+	 * @return Converted character.
+	 */
+	inline unsigned char toLowerASCII(const char c)
+	{
+		return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : (unsigned char) c;
+	}
+
+	/**
+	 * Parse a number written with thousands separators, such as
+	 * "81,799,600" or "42,894.8". Leading spaces are skipped.
+	 * @param text Text to parse. It does not need to be null terminated.
+	 * @param length Text length in bytes.
+	 * @param outValue Will contain the parsed value.
+	 * @return Number of characters used(including the skipped spaces), or
+	 * zero if the text does not start with a number.
+	 */
+	int parseNumber(const char* text, const int length, double& outValue);
+
+	/**
+	 * Open a file for writing. The file is created if it does not exist,
+	 * otherwise its content is removed.
+	 * @param filePath Path of the file to open.
+	 * @return File handle, or a negative value on error.
+	 */
+	MAHandle openFileForWriting(const MAUtil::String& filePath);
+
+	/**
+	 * Read the whole content of a file with a single read operation.
+	 * @param filePath Path of the file to read.
+	 * @param outSize Will contain the number of bytes read.
+	 * @return Buffer with file content allocated with malloc, or NULL if the
+	 * file could not be read. Its ownership is passed to the caller.
+	 */
+	char* readBinaryFile(const MAUtil::String& filePath, int& outSize);
+
+	/**
+	 * Check if a file exists.
+	 * @param filePath Path of the file.
+	 * @return true if the file exists, false otherwise.
+	 */
+	bool fileExists(const MAUtil::String& filePath);
+
+	/**
+	 * Delete a file.
+	 * @param filePath Path of the file.
+	 * @return true if the file was deleted, false otherwise.
+	 */
+	bool deleteFile(const MAUtil::String& filePath);
+
+	/**
+	 * Write a buffer to a file with a single write operation.
+	 * Old file content is removed.
+	 * @param filePath Path of the file to write.
+	 * @param data Data to write.
+	 * @param size Number of bytes to write.
+	 * @return true on success, false otherwise.
+	 */
+	bool writeBinaryFile(
+		const MAUtil::String& filePath,
+		const void* data,
+		const int size);
+
+	/**
+	 * Reverse the order of a range of items.
+	 * @param items Array that contains the range.
+	 * @param start Index of the first item.
+	 * @param end Index after the last item.
+	 */
+	template <typename T>
+	void reverseItems(T* items, int start, int end)
+	{
+		for (end--; start < end; start++, end--)
+		{
+			T swap = items[start];
+			items[start] = items[end];
+			items[end] = swap;
+		}
+	}
+
+	/**
+	 * Merge two adjacent sorted ranges without a buffer. Used by
+	 * mergeSort() if its buffer cannot be allocated. The merge is stable.
+	 * @param items Array that contains the ranges.
+	 * @param start Index of the first item of the first range.
+	 * @param middle Index of the first item of the second range.
+	 * @param end Index after the last item of the second range.
+	 * @param compare Same as for mergeSort().
+	 */
+	template <typename T, typename Compare>
+	void mergeInPlace(
+		T* items,
+		const int start,
+		const int middle,
+		const int end,
+		const Compare& compare)
+	{
+		if (start >= middle || middle >= end)
+		{
+			return;
+		}
+		if (end - start == 2)
+		{
+			if (compare(items[middle], items[start]) < 0)
+			{
+				reverseItems(items, start, end);
+			}
+			return;
+		}
+
+		// Split the longer range in half and find where its middle item
+		// goes in the other range.
+		int firstCut = 0;
+		int secondCut = 0;
+		if (middle - start > end - middle)
+		{
+			firstCut = start + (middle - start) / 2;
+			T value = items[firstCut];
+			int low = middle;
+			int high = end;
+			while (low < high)
+			{
+				int index = (low + high) / 2;
+				if (compare(items[index], value) < 0)
+				{
+					low = index + 1;
+				}
+				else
+				{
+					high = index;
+				}
+			}
+			secondCut = low;
+		}
+		else
+		{
+			secondCut = middle + (end - middle) / 2;
+			T value = items[secondCut];
+			int low = start;
+			int high = middle;
+			while (low < high)
+			{
+				int index = (low + high) / 2;
+				if (compare(value, items[index]) < 0)
+				{
+					high = index;
+				}
+				else
+				{
+					low = index + 1;
+				}
+			}
+			firstCut = low;
+		}
+
+		// Swap [firstCut, middle) and [middle, secondCut), then merge the
+		// two halves.
+		reverseItems(items, firstCut, middle);
+		reverseItems(items, middle, secondCut);
+		reverseItems(items, firstCut, secondCut);
+		int newMiddle = firstCut + (secondCut - middle);
+		mergeInPlace(items, start, firstCut, newMiddle, compare);
+		mergeInPlace(items, newMiddle, secondCut, end, compare);
+	}
+
+	/**
+	 * Sort an array with a stable bottom-up merge sort.
+	 * If the merge buffer cannot be allocated the items are merged in
+	 * place, which is slower but needs no memory.
+	 * @param items Items to sort. Items are copied with memcpy(), so they
+	 * must be plain values(ids, pointers, simple structs).
+	 * @param count Number of items.
+	 * @param compare Called as compare(first, second). Returns a negative
+	 * value if first goes before second, zero if they are equal and a
+	 * positive value otherwise.
+	 */
+	template <typename T, typename Compare>
+	void mergeSort(T* items, const int count, const Compare& compare)
+	{
+		if (count < 2)
+		{
+			return;
+		}
+
+		T* buffer = (T*) malloc(count * sizeof(T));
+		if (!buffer)
+		{
+			for (int width = 1; width < count; width *= 2)
+			{
+				for (int start = 0; start < count; start += 2 * width)
+				{
+					int middle = start + width < count ? start + width : count;
+					int end = middle + width < count ? middle + width : count;
+					mergeInPlace(items, start, middle, end, compare);
+				}
+			}
+			return;
+		}
+
+		T* source = items;
+		T* destination = buffer;
+		for (int width = 1; width < count; width *= 2)
+		{
+			for (int start = 0; start < count; start += 2 * width)
+			{
+				int middle = start + width < count ? start + width : count;
+				int end = middle + width < count ? middle + width : count;
+				int left = start;
+				int right = middle;
+				for (int index = start; index < end; index++)
+				{
+					bool takeLeft = right >= end ||
+						(left < middle && compare(source[left], source[right]) <= 0);
+					destination[index] = takeLeft ? source[left++] : source[right++];
+				}
+			}
+			T* swap = source;
+			source = destination;
+			destination = swap;
+		}
+
+		// The sorted items are in source.
+		if (source != items)
+		{
+			memcpy(items, source, count * sizeof(T));
+		}
+		free(buffer);
+	}
+
 } // end of EuropeanCountries
 
 #endif /* EC_MODEL_UTILS_H_ */
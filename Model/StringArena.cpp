@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file StringArena.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Stores many small strings in a few large memory blocks.
+ */
+
+#include <mastdlib.h>
+
+#include "StringArena.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Constructor.
+	 * @param blockSize Size of the memory blocks, in bytes.
+	 */
+	StringArena::StringArena(const int blockSize):
+		mBlockSize(blockSize),
+		mFreeSpace(NULL),
+		mFreeSize(0),
+		mUsedSize(0)
+	{
+	}
+
+	/**
+	 * Destructor.
+	 * Releases all strings.
+	 */
+	StringArena::~StringArena()
+	{
+		this->clear();
+	}
+
+	/**
+	 * Copy a text into the arena.
+	 * @param text Text to copy. It does not need to be null terminated.
+	 * @param length Text length in bytes.
+	 * @return Slice that points to the null terminated copy. It is valid
+	 * until the arena is cleared or destroyed. An empty slice is returned
+	 * if memory cannot be allocated.
+	 */
+	StringSlice StringArena::add(const char* text, const int length)
+	{
+		int size = length + 1;
+		char* destination = NULL;
+		if (size > mFreeSize)
+		{
+			if (size > mBlockSize / 4)
+			{
+				// Large texts get their own block, so the free space
+				// of the current block is not wasted.
+				destination = (char*) malloc(size);
+				if (!destination)
+				{
+					return emptySlice();
+				}
+				mBlocks.add(destination);
+			}
+			else
+			{
+				char* block = (char*) malloc(mBlockSize);
+				if (!block)
+				{
+					return emptySlice();
+				}
+				mFreeSpace = block;
+				mFreeSize = mBlockSize;
+				mBlocks.add(mFreeSpace);
+			}
+		}
+		if (!destination)
+		{
+			destination = mFreeSpace;
+			mFreeSpace += size;
+			mFreeSize -= size;
+		}
+
+		memcpy(destination, text, length);
+		destination[length] = '\0';
+		mUsedSize += size;
+
+		StringSlice slice;
+		slice.text = destination;
+		slice.length = length;
+		return slice;
+	}
+
+	/**
+	 * Take the ownership of a memory block that already contains
+	 * strings, so they can be used without being copied.
+	 * @param block Block allocated with malloc(). It is released
+	 * with the other blocks of the arena.
+	 */
+	void StringArena::adopt(char* block)
+	{
+		if (block)
+		{
+			mBlocks.add(block);
+		}
+	}
+
+	/**
+	 * Release all strings.
+	 */
+	void StringArena::clear()
+	{
+		for (int index = 0; index < mBlocks.size(); index++)
+		{
+			free(mBlocks[index]);
+		}
+		mBlocks.clear();
+		mFreeSpace = NULL;
+		mFreeSize = 0;
+		mUsedSize = 0;
+	}
+
+	/**
+	 * Get the number of bytes used by the strings added to arena.
+	 * @return Size in bytes, including the null characters.
+	 */
+	int StringArena::getSize() const
+	{
+		return mUsedSize;
+	}
+
+	/**
+	 * Get a slice for an empty text.
+	 * @return Slice that points to a static empty text.
+	 */
+	StringSlice StringArena::emptySlice()
+	{
+		StringSlice slice;
+		slice.text = "";
+		slice.length = 0;
+		return slice;
+	}
+
+} // end of EuropeanCountries
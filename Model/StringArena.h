@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file StringArena.h
+ * @author Bogdan Iusco
+ *
+ * @brief Stores many small strings in a few large memory blocks.
+ */
+
+#ifndef EC_STRING_ARENA_H_
+#define EC_STRING_ARENA_H_
+
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Text that is not owned by the object that refers to it.
+	 * The text is null terminated, the null character is not counted in
+	 * its length.
+	 */
+	struct StringSlice
+	{
+		const char* text;
+		int length;
+	};
+
+	/**
+	 * @brief Stores strings in large memory blocks.
+	 * Strings cannot be released one by one: all of them are released
+	 * when the arena is cleared or destroyed.
+	 */
+	class StringArena
+	{
+	public:
+		/**
+		 * Constructor.
+		 * @param blockSize Size of the memory blocks, in bytes.
+		 */
+		StringArena(const int blockSize = 64 * 1024);
+
+		/**
+		 * Destructor.
+		 * Releases all strings.
+		 */
+		~StringArena();
+
+		/**
+		 * Copy a text into the arena.
+		 * @param text Text to copy. It does not need to be null terminated.
+		 * @param length Text length in bytes.
+		 * @return Slice that points to the null terminated copy. It is valid
+		 * until the arena is cleared or destroyed. An empty slice is returned
+		 * if memory cannot be allocated.
+		 */
+		StringSlice add(const char* text, const int length);
+
+		/**
+		 * Take the ownership of a memory block that already contains
+		 * strings, so they can be used without being copied.
+		 * @param block Block allocated with malloc(). It is released
+		 * with the other blocks of the arena.
+		 */
+		void adopt(char* block);
+
+		/**
+		 * Release all strings.
+		 */
+		void clear();
+
+		/**
+		 * Get the number of bytes used by the strings added to arena.
+		 * @return Size in bytes, including the null characters.
+		 */
+		int getSize() const;
+
+		/**
+		 * Get a slice for an empty text.
+		 * @return Slice that points to a static empty text.
+		 */
+		static StringSlice emptySlice();
+
+	private:
+		/**
+		 * Size of a memory block.
+		 */
+		int mBlockSize;
+
+		/**
+		 * All memory blocks owned by the arena.
+		 */
+		MAUtil::Vector<char*> mBlocks;
+
+		/**
+		 * Free space in the current block.
+		 */
+		char* mFreeSpace;
+
+		/**
+		 * Number of bytes available at mFreeSpace.
+		 */
+		int mFreeSize;
+
+		/**
+		 * Number of bytes used by strings.
+		 */
+		int mUsedSize;
+
+	}; // end of StringArena
+
+} // end of EuropeanCountries
+
+#endif /* EC_STRING_ARENA_H_ */
@@ -23,23 +23,66 @@
  * @brief NativeUI Screen used to show a list of countries.
  */
 
+// Number of close names shown when no country contains the search text.
+#define MAX_SUGGESTED_COUNTRIES 5
+
+// Number of rows shown by list items. Longer lists are shown in windows
+// of this size.
+#define LIST_WINDOW_ROWS 60
+
+// Number of rows shown both before and after moving the window.
+#define LIST_OVERSCAN_ROWS 10
+
+#include <NativeUI/EditBox.h>
 #include <NativeUI/Image.h>
 #include <NativeUI/ListView.h>
 #include <NativeUI/ListViewSection.h>
 #include <NativeUI/ListViewItem.h>
 #include <NativeUI/RelativeLayout.h>
 #include <MAUtil/String.h>
+#include <mastdlib.h>
 
 #include "CountriesListScreen.h"
 #include "CountriesListScreenObserver.h"
 #include "MAHeaders.h"
 #include "ViewUtils.h"
 #include "../Model/ICountryDatabase.h"
-#include "../Model/Country.h"
+#include "../Model/CountrySummaryTable.h"
 
 namespace EuropeanCountries
 {
 
+	/**
+	 * Sort order that can be selected from the options menu.
+	 */
+	struct SortOption
+	{
+		const char* title;
+		CountrySortField field;
+		bool ascending;
+	};
+
+	/**
+	 * Sort orders shown in the options menu, in menu order.
+	 */
+	static const SortOption sSortOptions[] =
+	{
+		{ "Sort by name", CountrySortByName, true },
+		{ "Sort by capital", CountrySortByCapital, true },
+		{ "Largest population first", CountrySortByPopulation, false },
+		{ "Largest area first", CountrySortByArea, false }
+	};
+
+	/**
+	 * Texts shown by a list item, in display order.
+	 */
+	enum ItemText
+	{
+		ItemTextName = 0,
+		ItemTextNameAndCapital,
+		ItemTextCapitalAndName
+	};
+
 	/**
 	 * Constructor.
 	 * @param database Used to read data.
@@ -50,7 +93,19 @@ namespace EuropeanCountries
 		CountriesListScreenObserver& observer):
 		mDatabase(database),
 		mObserver(observer),
-		mMainLayout(NULL)
+		mMainLayout(NULL),
+		mSearchBox(NULL),
+		mListView(NULL),
+		mWindowStart(0),
+		mPreviousPageSection(NULL),
+		mPreviousPageItem(NULL),
+		mNextPageSection(NULL),
+		mNextPageItem(NULL),
+		mPreviousPageShown(false),
+		mNextPageShown(false),
+		mSortField(CountrySortByName),
+		mSortAscending(true),
+		mListIsOutdated(false)
 	{
 		if (isIOS())
 		{
@@ -58,6 +113,9 @@ namespace EuropeanCountries
 		}
 		this->createUI();
 		mListView->addListViewListener(this);
+		mSearchBox->addEditBoxListener(this);
+		this->addScreenListener(this);
+		mDatabase.addObserver(*this);
 	}
 
 	/**
@@ -66,6 +124,27 @@ namespace EuropeanCountries
 	CountriesListScreen::~CountriesListScreen()
 	{
 		mListView->removeListViewListener(this);
+		mSearchBox->removeEditBoxListener(this);
+		this->removeScreenListener(this);
+		mDatabase.removeObserver(*this);
+
+		// Widgets that are not in the list are not deleted with it.
+		for (int index = 0; index < mSpareItems.size(); index++)
+		{
+			delete mSpareItems[index];
+		}
+		for (int index = 0; index < mSpareSections.size(); index++)
+		{
+			delete mSpareSections[index];
+		}
+		if (!mPreviousPageShown)
+		{
+			delete mPreviousPageSection;
+		}
+		if (!mNextPageShown)
+		{
+			delete mNextPageSection;
+		}
 	}
 
 	/**
@@ -80,6 +159,19 @@ namespace EuropeanCountries
 		NativeUI::ListViewSection* listViewSection,
 		NativeUI::ListViewItem* listViewItem)
 	{
+		if (listViewItem == mPreviousPageItem)
+		{
+			mWindowStart -= LIST_WINDOW_ROWS - LIST_OVERSCAN_ROWS;
+			this->showListWindow();
+			return;
+		}
+		if (listViewItem == mNextPageItem)
+		{
+			mWindowStart += LIST_WINDOW_ROWS - LIST_OVERSCAN_ROWS;
+			this->showListWindow();
+			return;
+		}
+
 		int countryID = mCountryMap[listViewItem->getWidgetHandle()];
 		mObserver.showCountryInfoScreen(countryID);
 	}
@@ -94,6 +186,135 @@ namespace EuropeanCountries
 		NativeUI::Screen::show();
 	}
 
+	/**
+	 * Called when an options menu item is selected.
+	 * The list is sorted using the selected order.
+	 * From ScreenListener.
+	 * @param screen The screen that generated the event.
+	 * @param index The index of the selected menu item.
+	 */
+	void CountriesListScreen::optionsMenuItemSelected(
+		NativeUI::Screen* screen,
+		int index)
+	{
+		int countOptions = sizeof(sSortOptions) / sizeof(sSortOptions[0]);
+		if (index < 0 || index >= countOptions)
+		{
+			return;
+		}
+
+		const SortOption& option = sSortOptions[index];
+		if (option.field == mSortField && option.ascending == mSortAscending)
+		{
+			return;
+		}
+		mSortField = option.field;
+		mSortAscending = option.ascending;
+		this->addDataToListView();
+	}
+
+	/**
+	 * This method is called when the search box text was changed.
+	 * The list will show only the countries that match the text.
+	 * From EditBoxListener.
+	 * @param editBox The edit box object that generated the event.
+	 * @param text The new text.
+	 */
+	void CountriesListScreen::editBoxTextChanged(
+		NativeUI::EditBox* editBox,
+		const MAUtil::String& text)
+	{
+		if (text == mSearchText)
+		{
+			return;
+		}
+		mSearchText = text;
+		this->addDataToListView();
+	}
+
+	/**
+	 * This method is called when the return button was pressed.
+	 * The keyboard is hidden.
+	 * From EditBoxListener.
+	 * @param editBox The edit box object that generated the event.
+	 */
+	void CountriesListScreen::editBoxReturn(NativeUI::EditBox* editBox)
+	{
+		editBox->hideKeyboard();
+	}
+
+	/**
+	 * Called after countries were added at the end of the database.
+	 * If the list is sorted by name and not filtered they are appended
+	 * to it, otherwise they are shown when loading finishes.
+	 * From CountryDatabaseObserver.
+	 * @param firstID Id of the first added country.
+	 * @param countCountries Number of added countries.
+	 */
+	void CountriesListScreen::countriesAdded(
+		const int firstID,
+		const int countCountries)
+	{
+		if (mSearchText.length() > 0 ||
+			mSortField != CountrySortByName ||
+			!mSortAscending)
+		{
+			mListIsOutdated = true;
+			return;
+		}
+
+		// Countries are appended in id order. If a name comes before the
+		// previous one the list is sorted again when loading finishes.
+		const CountrySummaryTable& summaryTable = mDatabase.getSummaryTable();
+		int endID = firstID + countCountries;
+		for (int countryID = firstID; countryID < endID; countryID++)
+		{
+			char firstLetter = summaryTable.getFirstLetter(countryID);
+			if (firstLetter == '\0')
+			{
+				continue;
+			}
+			int countRows = mListIndex.countRows();
+			if (countRows > 0 &&
+				strcmp(summaryTable.getName(countryID).text,
+					summaryTable.getName(
+						mListIndex.getCountryID(countRows - 1)).text) < 0)
+			{
+				mListIsOutdated = true;
+			}
+			mListIndex.addRow(countryID, firstLetter, false);
+		}
+		this->showListWindow();
+	}
+
+	/**
+	 * Called after all countries were removed from the database.
+	 * The list is cleared.
+	 * From CountryDatabaseObserver.
+	 */
+	void CountriesListScreen::countriesRemoved()
+	{
+		// Ids of the next countries refer to other data, so all items
+		// are set again.
+		mCountryMap.clear();
+		mItemTexts.clear();
+		this->addDataToListView();
+	}
+
+	/**
+	 * Called when the database is fully loaded.
+	 * The list is rebuilt if it does not show all countries in the
+	 * selected order.
+	 * From CountryDatabaseObserver.
+	 */
+	void CountriesListScreen::loadingFinished()
+	{
+		if (mListIsOutdated)
+		{
+			this->addDataToListView();
+		}
+	}
+
 	/**
 	 * Create screen UI.
 	 */
@@ -103,7 +324,10 @@ namespace EuropeanCountries
 		this->setMainWidget(mMainLayout);
 
 		this->createImageWidget();
+		this->createSearchBoxWidget();
 		this->createListViewWidget();
+		this->createPageSections();
+		this->createOptionsMenu();
 		this->addDataToListView();
 	}
 
@@ -123,6 +347,20 @@ namespace EuropeanCountries
 		mMainLayout->addChild(imageWidget);
 	}
 
+	/**
+	 * Create and add the search box to the top of the screen's main layout.
+	 */
+	void CountriesListScreen::createSearchBoxWidget()
+	{
+		mSearchBox = new NativeUI::EditBox();
+		mSearchBox->setHeight(gScreenHeight / 10);
+		mSearchBox->setWidth(gScreenWidth);
+		mSearchBox->setTopPosition(0);
+		mSearchBox->setLeftPosition(0);
+		mSearchBox->setPlaceholder("Search country or capital");
+		mMainLayout->addChild(mSearchBox);
+	}
+
 	/**
 	 * Create and add an ListView widget to the screen's main layout.
 	 * It will take the screen size and will be placed above the image widget.
@@ -131,9 +369,10 @@ namespace EuropeanCountries
 	{
 		mListView = new NativeUI::ListView(
 			NativeUI::LIST_VIEW_TYPE_ALPHABETICAL);
-		mListView->setHeight(gScreenHeight);
+		int searchBoxHeight = gScreenHeight / 10;
+		mListView->setHeight(gScreenHeight - searchBoxHeight);
 		mListView->setWidth(gScreenWidth);
-		mListView->setTopPosition(0);
+		mListView->setTopPosition(searchBoxHeight);
 		mListView->setLeftPosition(0);
 		if (!isWindowsPhone())
 		{
@@ -142,58 +381,361 @@ namespace EuropeanCountries
 		mMainLayout->addChild(mListView);
 	}
 
+	/**
+	 * Create the sections used to move the window to the previous
+	 * and to the next rows. They are shown only if such rows exist.
+	 */
+	void CountriesListScreen::createPageSections()
+	{
+		mPreviousPageSection = new NativeUI::ListViewSection(
+			NativeUI::LIST_VIEW_SECTION_TYPE_ALPHABETICAL);
+		mPreviousPageSection->setTitle("<");
+		mPreviousPageItem = new NativeUI::ListViewItem();
+		mPreviousPageItem->setText("Previous countries");
+		mPreviousPageItem->setFontColor(COLOR_WHITE);
+		mPreviousPageSection->addItem(mPreviousPageItem);
+
+		mNextPageSection = new NativeUI::ListViewSection(
+			NativeUI::LIST_VIEW_SECTION_TYPE_ALPHABETICAL);
+		mNextPageSection->setTitle(">");
+		mNextPageItem = new NativeUI::ListViewItem();
+		mNextPageItem->setText("More countries");
+		mNextPageItem->setFontColor(COLOR_WHITE);
+		mNextPageSection->addItem(mNextPageItem);
+	}
+
+	/**
+	 * Add an options menu item for each available sort order.
+	 */
+	void CountriesListScreen::createOptionsMenu()
+	{
+		int countOptions = sizeof(sSortOptions) / sizeof(sSortOptions[0]);
+		for (int index = 0; index < countOptions; index++)
+		{
+			this->addOptionsMenuItem(sSortOptions[index].title);
+		}
+	}
+
 	/**
 	 * Add data from database into list view.
+	 * Countries are shown in the current sort order. If a search text
+	 * is set, only the countries that match it are shown, or the closest
+	 * ones if none matches. The window is moved to the first row.
 	 */
 	void CountriesListScreen::addDataToListView()
 	{
-		// Clear data from map.
-		mCountryMap.clear();
+		// Clear the rows. Shown items are updated by showListWindow(), items
+		// that keep their country and texts are not changed.
+		mListIndex.clear();
+		mListIsOutdated = false;
 
-		// Create first section.
-		NativeUI::ListViewSection* section = NULL;
-		MAUtil::String sectionTitle("A");
-
-		// For each country read create and add an ListViewItem widget.
-		int countCountries = mDatabase.countCountries();
+		// Add a row for each country read. Only the summary table is read,
+		// Country objects are not touched.
+		const CountrySummaryTable& summaryTable = mDatabase.getSummaryTable();
+		const MAUtil::Vector<int>& sortedIDs =
+			mDatabase.getSortedCountryIDs(mSortField, mSortAscending);
+		bool sortedByCapital = mSortField == CountrySortByCapital;
+		bool sortedByText = sortedByCapital || mSortField == CountrySortByName;
+		bool filtered = mSearchText.length() > 0;
+		bool suggested = false;
+		if (filtered)
+		{
+			mDatabase.searchCountries(mSearchText, sortedIDs, mSearchMatches);
+			suggested = mSearchMatches.size() == 0;
+		}
+		if (suggested)
+		{
+			// Nothing contains the text, show the closest names instead,
+			// best match first.
+			MAUtil::Vector<CountryFuzzyMatch> fuzzyMatches;
+			mDatabase.findCountriesFuzzy(mSearchText, MAX_SUGGESTED_COUNTRIES,
+				fuzzyMatches);
+			for (int index = 0; index < fuzzyMatches.size(); index++)
+			{
+				CountryMatch match;
+				match.countryID = fuzzyMatches[index].countryID;
+				match.field = fuzzyMatches[index].field;
+				match.position = 0;
+				match.length = 0;
+				mSearchMatches.add(match);
+			}
+		}
+		int countCountries = filtered ? mSearchMatches.size() : sortedIDs.size();
 		for (int index = 0; index < countCountries; index++)
 		{
-			// If index is invalid skip this country.
-			Country* country = mDatabase.getCountryByIndex(index);
-			if (!country)
+			// If country's name is an empty string skip this country.
+			int countryID = filtered ?
+				mSearchMatches[index].countryID : sortedIDs[index];
+			char firstLetter = summaryTable.getFirstLetter(countryID);
+			if (firstLetter == '\0')
 			{
 				continue;
 			}
 
-			// If country's name is an empty string skip this country.
-			MAUtil::String countryName = country->getName();
-			if (countryName.length() == 0)
+			// Countries sorted by a number and suggested countries are shown
+			// in a single section.
+			char sectionLetter = '#';
+			if (suggested)
 			{
-				continue;
+				sectionLetter = '?';
+			}
+			else if (sortedByCapital)
+			{
+				sectionLetter = summaryTable.getCapital(countryID).text[0];
+			}
+			else if (sortedByText)
+			{
+				sectionLetter = firstLetter;
+			}
+			if (sectionLetter == '\0')
+			{
+				sectionLetter = '#';
+			}
+
+			bool matchedCapital = filtered &&
+				mSearchMatches[index].field == CountrySearchCapital;
+			mListIndex.addRow(countryID, sectionLetter, matchedCapital);
+		}
+
+		mWindowStart = 0;
+		this->showListWindow();
+	}
+
+	/**
+	 * Show the rows of the window starting at mWindowStart.
+	 * Widgets that are not needed are kept for later use, and only
+	 * items that show another country are updated.
+	 */
+	void CountriesListScreen::showListWindow()
+	{
+		// Keep the window inside the list.
+		int countRows = mListIndex.countRows();
+		if (mWindowStart > countRows - LIST_WINDOW_ROWS)
+		{
+			mWindowStart = countRows - LIST_WINDOW_ROWS;
+		}
+		if (mWindowStart < 0)
+		{
+			mWindowStart = 0;
+		}
+		int windowEnd = mWindowStart + LIST_WINDOW_ROWS;
+		if (windowEnd > countRows)
+		{
+			windowEnd = countRows;
+		}
+
+		// Find the sections of the window rows. Sections of other rows
+		// have no widgets.
+		int firstSection = 0;
+		int countSections = 0;
+		if (windowEnd > mWindowStart)
+		{
+			firstSection = mListIndex.findSection(mWindowStart);
+			countSections =
+				mListIndex.findSection(windowEnd - 1) - firstSection + 1;
+		}
+
+		// The previous page section is the first one in the list.
+		bool showPreviousPage = mWindowStart > 0;
+		if (showPreviousPage && !mPreviousPageShown)
+		{
+			mListView->insertChild(mPreviousPageSection, 0);
+		}
+		else if (!showPreviousPage && mPreviousPageShown)
+		{
+			mListView->removeChild(mPreviousPageSection);
+		}
+		mPreviousPageShown = showPreviousPage;
+
+		// The next page section is the last one in the list, so it is
+		// removed while sections are added.
+		bool showNextPage = windowEnd < countRows;
+		if (mNextPageShown &&
+			(!showNextPage || countSections > mWindowSections.size()))
+		{
+			mListView->removeChild(mNextPageSection);
+			mNextPageShown = false;
+		}
+
+		// Remove the sections and items that are not needed.
+		while (mWindowSections.size() > countSections)
+		{
+			int last = mWindowSections.size() - 1;
+			NativeUI::ListViewSection* section = mWindowSections[last];
+			this->releaseItems(section, 0);
+			mListView->removeChild(section);
+			mSpareSections.add(section);
+			mWindowSections.remove(last);
+			mWindowSectionLetters.remove(last);
+		}
+		for (int index = 0; index < mWindowSections.size(); index++)
+		{
+			int section = firstSection + index;
+			int sectionStart = mListIndex.getSectionStart(section);
+			int sectionEnd = mListIndex.getSectionEnd(section);
+			int first = sectionStart > mWindowStart ? sectionStart : mWindowStart;
+			int end = sectionEnd < windowEnd ? sectionEnd : windowEnd;
+			this->releaseItems(mWindowSections[index], end - first);
+		}
+
+		// Show the window rows.
+		for (int index = 0; index < countSections; index++)
+		{
+			int section = firstSection + index;
+			char sectionLetter = mListIndex.getSectionLetter(section);
+			if (index == mWindowSections.size())
+			{
+				NativeUI::ListViewSection* sectionWidget = NULL;
+				if (mSpareSections.size() > 0)
+				{
+					int last = mSpareSections.size() - 1;
+					sectionWidget = mSpareSections[last];
+					mSpareSections.remove(last);
+				}
+				else
+				{
+					sectionWidget = new NativeUI::ListViewSection(
+						NativeUI::LIST_VIEW_SECTION_TYPE_ALPHABETICAL);
+				}
+				mListView->addChild(sectionWidget);
+				mWindowSections.add(sectionWidget);
+				mWindowSectionLetters.add('\0');
+			}
+
+			NativeUI::ListViewSection* sectionWidget = mWindowSections[index];
+			if (mWindowSectionLetters[index] != sectionLetter)
+			{
+				MAUtil::String sectionTitle(" ");
+				sectionTitle[0] = sectionLetter;
+				sectionWidget->setTitle(sectionTitle);
+				sectionWidget->setHeaderText(sectionTitle);
+				mWindowSectionLetters[index] = sectionLetter;
 			}
 
-			// Check if current country can go into current section.
-			if (!section || countryName[0] != sectionTitle[0])
+			int sectionStart = mListIndex.getSectionStart(section);
+			int sectionEnd = mListIndex.getSectionEnd(section);
+			int first = sectionStart > mWindowStart ? sectionStart : mWindowStart;
+			int end = sectionEnd < windowEnd ? sectionEnd : windowEnd;
+			for (int row = first; row < end; row++)
 			{
-				// Create new section.
-				sectionTitle[0] = countryName[0];
-				section = new NativeUI::ListViewSection(
-					NativeUI::LIST_VIEW_SECTION_TYPE_ALPHABETICAL);
-				section->setTitle(sectionTitle);
-				section->setHeaderText(sectionTitle);
-				mListView->addChild(section);
+				NativeUI::ListViewItem* item = NULL;
+				if (row - first < sectionWidget->countChildWidgets())
+				{
+					item = (NativeUI::ListViewItem*)
+						sectionWidget->getChild(row - first);
+				}
+				else
+				{
+					item = this->getSpareItem();
+					sectionWidget->addItem(item);
+				}
+				this->bindItem(item, row);
 			}
+		}
+
+		if (showNextPage && !mNextPageShown)
+		{
+			mListView->addChild(mNextPageSection);
+			mNextPageShown = true;
+		}
+	}
 
-			// Create and add list item for this country.
-			NativeUI::ListViewItem* item = new NativeUI::ListViewItem();
-			item->setText(countryName);
-			item->setFontColor(COLOR_WHITE);
-			item->setSelectionStyle(NativeUI::LIST_VIEW_ITEM_SELECTION_STYLE_GRAY);
-			item->setIcon(country->getFlagID());
-			section->addItem(item);
+	/**
+	 * Remove the last items of a section and keep them for later use.
+	 * @param section Section that contains the items.
+	 * @param countItems Number of items left in the section.
+	 */
+	void CountriesListScreen::releaseItems(
+		NativeUI::ListViewSection* section,
+		const int countItems)
+	{
+		while (section->countChildWidgets() > countItems)
+		{
+			NativeUI::ListViewItem* item = (NativeUI::ListViewItem*)
+				section->getChild(section->countChildWidgets() - 1);
+			section->removeChild(item);
+			mCountryMap.erase(item->getWidgetHandle());
+			mItemTexts.erase(item->getWidgetHandle());
+			mSpareItems.add(item);
+		}
+	}
 
-			mCountryMap.insert(item->getWidgetHandle(), country->getID());
+	/**
+	 * Get an unused list item or create one.
+	 * @return The item. Its text is not set.
+	 */
+	NativeUI::ListViewItem* CountriesListScreen::getSpareItem()
+	{
+		if (mSpareItems.size() > 0)
+		{
+			int last = mSpareItems.size() - 1;
+			NativeUI::ListViewItem* item = mSpareItems[last];
+			mSpareItems.remove(last);
+			return item;
+		}
+
+		NativeUI::ListViewItem* item = new NativeUI::ListViewItem();
+		item->setFontColor(COLOR_WHITE);
+		item->setSelectionStyle(NativeUI::LIST_VIEW_ITEM_SELECTION_STYLE_GRAY);
+		return item;
+	}
+
+	/**
+	 * Show a row of mListIndex in a given item.
+	 * Nothing is changed if the item already shows the row's country
+	 * with the same texts.
+	 * @param item The item.
+	 * @param row Row index.
+	 */
+	void CountriesListScreen::bindItem(
+		NativeUI::ListViewItem* item,
+		const int row)
+	{
+		int countryID = mListIndex.getCountryID(row);
+		int itemText = ItemTextName;
+		if (mSortField == CountrySortByCapital)
+		{
+			itemText = ItemTextCapitalAndName;
+		}
+		else if (mListIndex.isCapitalMatch(row))
+		{
+			// Show why the country was found.
+			itemText = ItemTextNameAndCapital;
+		}
+
+		int handle = item->getWidgetHandle();
+		MAUtil::Map<int, int>::Iterator shown = mCountryMap.find(handle);
+		if (shown != mCountryMap.end() && shown->second == countryID &&
+			mItemTexts[handle] == itemText)
+		{
+			return;
+		}
+
+		const CountrySummaryTable& summaryTable = mDatabase.getSummaryTable();
+		if (itemText == ItemTextNameAndCapital)
+		{
+			MAUtil::String text = summaryTable.getName(countryID).text;
+			text += " (";
+			text += summaryTable.getCapital(countryID).text;
+			text += ")";
+			item->setText(text);
+		}
+		else if (itemText == ItemTextCapitalAndName)
+		{
+			MAUtil::String text = summaryTable.getCapital(countryID).text;
+			text += " (";
+			text += summaryTable.getName(countryID).text;
+			text += ")";
+			item->setText(text);
+		}
+		else
+		{
+			setWidgetText(item, MAW_LIST_VIEW_ITEM_TEXT,
+				summaryTable.getName(countryID).text);
 		}
+		item->setIcon(summaryTable.getFlagID(countryID));
+		mCountryMap[handle] = countryID;
+		mItemTexts[handle] = itemText;
 	}
 
 } // end of EuropeanCountries
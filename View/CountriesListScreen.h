@@ -27,13 +27,25 @@
 #define EC_COUNTRIES_LIST_SCREEN_H_
 
 #include <NativeUI/Screen.h>
+#include <NativeUI/EditBoxListener.h>
 #include <NativeUI/ListViewListener.h>
+#include <NativeUI/ScreenListener.h>
 #include <MAUtil/Map.h>
+#include <MAUtil/String.h>
+#include <MAUtil/Vector.h>
+
+#include "../Model/CountryDatabaseObserver.h"
+#include "../Model/CountrySearchIndex.h"
+#include "../Model/CountrySortIndex.h"
+#include "CountryListIndex.h"
 
 // Forward declaration for NativeUI namespace classes.
 namespace NativeUI
 {
+	class EditBox;
 	class ListView;
+	class ListViewItem;
+	class ListViewSection;
 	class RelativeLayout;
 }
 
@@ -45,10 +57,18 @@ namespace EuropeanCountries
 
 	/**
 	 * @brief Screen used to show a list of countries.
+	 * Countries added while the database is loading are appended to the
+	 * list, so it can be used before all of them are read.
+	 * Only a window of rows is shown by widgets. The user moves it with
+	 * the first and last list items, and its widgets are reused for the
+	 * rows it moves to.
 	 */
 	class CountriesListScreen:
 		public NativeUI::Screen,
-		public NativeUI::ListViewListener
+		public NativeUI::ListViewListener,
+		public NativeUI::ScreenListener,
+		public NativeUI::EditBoxListener,
+		public CountryDatabaseObserver
 	{
 	public:
 		/**
@@ -92,6 +112,84 @@ namespace EuropeanCountries
 		 */
 		virtual void show();
 
+		/**
+		 * Called when an options menu item is selected.
+		 * The list is sorted using the selected order.
+		 * From ScreenListener.
+		 * @param screen The screen that generated the event.
+		 * @param index The index of the selected menu item.
+		 */
+		virtual void optionsMenuItemSelected(
+			NativeUI::Screen* screen,
+			int index);
+
+		/**
+		 * Called when the options menu is closed.
+		 * From ScreenListener.
+		 * @param screen The screen that generated the event.
+		 */
+		virtual void optionsMenuClosed(NativeUI::Screen* screen) {};
+
+		/**
+		 * This method is called when an edit box gains focus.
+		 * From EditBoxListener.
+		 * @param editBox The edit box object that generated the event.
+		 */
+		virtual void editBoxEditingDidBegin(NativeUI::EditBox* editBox) {};
+
+		/**
+		 * This method is called when an edit box loses focus.
+		 * From EditBoxListener.
+		 * @param editBox The edit box object that generated the event.
+		 */
+		virtual void editBoxEditingDidEnd(NativeUI::EditBox* editBox) {};
+
+		/**
+		 * This method is called when the search box text was changed.
+		 * The list will show only the countries that match the text.
+		 * From EditBoxListener.
+		 * @param editBox The edit box object that generated the event.
+		 * @param text The new text.
+		 */
+		virtual void editBoxTextChanged(
+			NativeUI::EditBox* editBox,
+			const MAUtil::String& text);
+
+		/**
+		 * This method is called when the return button was pressed.
+		 * The keyboard is hidden.
+		 * From EditBoxListener.
+		 * @param editBox The edit box object that generated the event.
+		 */
+		virtual void editBoxReturn(NativeUI::EditBox* editBox);
+
+		/**
+		 * Called after countries were added at the end of the database.
+		 * If the list is sorted by name and not filtered they are appended
+		 * to it, otherwise they are shown when loading finishes.
+		 * From CountryDatabaseObserver.
+		 * @param firstID Id of the first added country.
+		 * @param countCountries Number of added countries.
+		 */
+		virtual void countriesAdded(
+			const int firstID,
+			const int countCountries);
+
+		/**
+		 * Called after all countries were removed from the database.
+		 * The list is cleared.
+		 * From CountryDatabaseObserver.
+		 */
+		virtual void countriesRemoved();
+
+		/**
+		 * Called when the database is fully loaded.
+		 * The list is rebuilt if it does not show all countries in the
+		 * selected order.
+		 * From CountryDatabaseObserver.
+		 */
+		virtual void loadingFinished();
+
 	private:
 		/**
 		 * Create screen UI.
@@ -104,17 +202,67 @@ namespace EuropeanCountries
 		 */
 		void createImageWidget();
 
+		/**
+		 * Create and add the search box to the top of the screen's main layout.
+		 */
+		void createSearchBoxWidget();
+
 		/**
 		 * Create and add an ListView widget to the screen's main layout.
 		 * It will take the screen size and will be placed above the image widget.
 		 */
 		void createListViewWidget();
 
+		/**
+		 * Add an options menu item for each available sort order.
+		 */
+		void createOptionsMenu();
+
+		/**
+		 * Create the sections used to move the window to the previous
+		 * and to the next rows. They are shown only if such rows exist.
+		 */
+		void createPageSections();
+
 		/**
 		 * Add data from database into list view.
+		 * Countries are shown in the current sort order. If a search text
+		 * is set, only the countries that match it are shown. The window
+		 * is moved to the first row.
 		 */
 		void addDataToListView();
 
+		/**
+		 * Show the rows of the window starting at mWindowStart.
+		 * Widgets that are not needed are kept for later use, and only
+		 * items that show another country are updated.
+		 */
+		void showListWindow();
+
+		/**
+		 * Remove the last items of a section and keep them for later use.
+		 * @param section Section that contains the items.
+		 * @param countItems Number of items left in the section.
+		 */
+		void releaseItems(
+			NativeUI::ListViewSection* section,
+			const int countItems);
+
+		/**
+		 * Get an unused list item or create one.
+		 * @return The item. Its text is not set.
+		 */
+		NativeUI::ListViewItem* getSpareItem();
+
+		/**
+		 * Show a row of mListIndex in a given item.
+		 * Nothing is changed if the item already shows the row's country
+		 * with the same texts.
+		 * @param item The item.
+		 * @param row Row index.
+		 */
+		void bindItem(NativeUI::ListViewItem* item, const int row);
+
 	private:
 		/**
 		 * Database used to read data displayed by list view.
@@ -131,6 +279,11 @@ namespace EuropeanCountries
 		 */
 		NativeUI::RelativeLayout* mMainLayout;
 
+		/**
+		 * Search box shown above the list.
+		 */
+		NativeUI::EditBox* mSearchBox;
+
 		/**
 		 * ListView that shows the country names.
 		 */
@@ -140,9 +293,104 @@ namespace EuropeanCountries
 		 * Store pairs of:
 		 * - key: ListViewItem handle.
 		 * - value: Country's id used to populate the ListViewItem.
+		 * Only items shown by the list are stored.
 		 */
 		MAUtil::Map<int, int> mCountryMap;
 
+		/**
+		 * Store pairs of:
+		 * - key: ListViewItem handle.
+		 * - value: Texts shown by the ListViewItem(ItemText value).
+		 * Contains the same items as mCountryMap.
+		 */
+		MAUtil::Map<int, int> mItemTexts;
+
+		/**
+		 * All rows and sections of the list.
+		 */
+		CountryListIndex mListIndex;
+
+		/**
+		 * First row shown by the list.
+		 */
+		int mWindowStart;
+
+		/**
+		 * Sections that show the window rows, in list order.
+		 */
+		MAUtil::Vector<NativeUI::ListViewSection*> mWindowSections;
+
+		/**
+		 * Letter shown by each section from mWindowSections.
+		 */
+		MAUtil::Vector<char> mWindowSectionLetters;
+
+		/**
+		 * Sections removed from the list, kept for later use.
+		 */
+		MAUtil::Vector<NativeUI::ListViewSection*> mSpareSections;
+
+		/**
+		 * Items removed from the list, kept for later use.
+		 */
+		MAUtil::Vector<NativeUI::ListViewItem*> mSpareItems;
+
+		/**
+		 * First section of the list if rows exist before the window.
+		 */
+		NativeUI::ListViewSection* mPreviousPageSection;
+
+		/**
+		 * Item that moves the window to the previous rows.
+		 */
+		NativeUI::ListViewItem* mPreviousPageItem;
+
+		/**
+		 * Last section of the list if rows exist after the window.
+		 */
+		NativeUI::ListViewSection* mNextPageSection;
+
+		/**
+		 * Item that moves the window to the next rows.
+		 */
+		NativeUI::ListViewItem* mNextPageItem;
+
+		/**
+		 * True if mPreviousPageSection is added to the list.
+		 */
+		bool mPreviousPageShown;
+
+		/**
+		 * True if mNextPageSection is added to the list.
+		 */
+		bool mNextPageShown;
+
+		/**
+		 * Field used to sort the list.
+		 */
+		CountrySortField mSortField;
+
+		/**
+		 * True if the list is sorted in ascending order.
+		 */
+		bool mSortAscending;
+
+		/**
+		 * Text typed in the search box.
+		 */
+		MAUtil::String mSearchText;
+
+		/**
+		 * Countries that match mSearchText, in list order.
+		 */
+		MAUtil::Vector<CountryMatch> mSearchMatches;
+
+		/**
+		 * True if countries were added that the list does not show in
+		 * the selected order.
+		 */
+		bool mListIsOutdated;
+
 	}; // end of CountriesListScreen
 
 } // end of EuropeanCountries
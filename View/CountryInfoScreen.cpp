@@ -128,12 +128,16 @@ namespace EuropeanCountries
 	 */
 	void CountryInfoScreen::setDisplayedCountry(const Country& country)
 	{
-		mNameLabel->setText(country.getName());
-		mPopulationLabel->setText(country.getPopulation());
-		mAreaLabel->setText(country.getArea());
-		mLanguagesLabel->setText(country.getLanguages());
-		mGovernmentLabel->setText(country.getGovernment());
-		mCapitalLabel->setText(country.getCapital());
+		setWidgetText(mNameLabel, MAW_LABEL_TEXT, country.getNameSlice().text);
+		setWidgetText(mPopulationLabel, MAW_LABEL_TEXT,
+			country.getPopulationSlice().text);
+		setWidgetText(mAreaLabel, MAW_LABEL_TEXT, country.getAreaSlice().text);
+		setWidgetText(mLanguagesLabel, MAW_LABEL_TEXT,
+			country.getLanguagesSlice().text);
+		setWidgetText(mGovernmentLabel, MAW_LABEL_TEXT,
+			country.getGovernmentSlice().text);
+		setWidgetText(mCapitalLabel, MAW_LABEL_TEXT,
+			country.getCapitalSlice().text);
 	}
 
 	/**
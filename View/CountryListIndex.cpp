@@ -0,0 +1,171 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryListIndex.cpp
+ * @author Bogdan Iusco
+ *
+ * @brief Rows and sections of the countries list.
+ */
+
+#include "CountryListIndex.h"
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * Constructor.
+	 */
+	CountryListIndex::CountryListIndex()
+	{
+	}
+
+	/**
+	 * Remove all rows and sections.
+	 */
+	void CountryListIndex::clear()
+	{
+		mCountryIDs.clear();
+		mCapitalMatches.clear();
+		mSectionLetters.clear();
+		mSectionStarts.clear();
+	}
+
+	/**
+	 * Add a row at the end of the list.
+	 * A new section is started if its letter differs from the letter
+	 * of the previous row.
+	 * @param countryID Id of the country shown by the row.
+	 * @param sectionLetter Letter of the row's section.
+	 * @param matchedCapital True if the country was found by its
+	 * capital.
+	 */
+	void CountryListIndex::addRow(
+		const int countryID,
+		const char sectionLetter,
+		const bool matchedCapital)
+	{
+		int countSections = mSectionLetters.size();
+		if (countSections == 0 ||
+			mSectionLetters[countSections - 1] != sectionLetter)
+		{
+			mSectionLetters.add(sectionLetter);
+			mSectionStarts.add(mCountryIDs.size());
+		}
+		mCountryIDs.add(countryID);
+		mCapitalMatches.add(matchedCapital);
+	}
+
+	/**
+	 * Get the number of rows.
+	 * @return Number of rows.
+	 */
+	int CountryListIndex::countRows() const
+	{
+		return mCountryIDs.size();
+	}
+
+	/**
+	 * Get the country shown by a row.
+	 * @param row Row index. Must be >=0 and < countRows().
+	 * @return Country's id.
+	 */
+	int CountryListIndex::getCountryID(const int row) const
+	{
+		return mCountryIDs[row];
+	}
+
+	/**
+	 * Check if the country of a row was found by its capital.
+	 * @param row Row index. Must be >=0 and < countRows().
+	 * @return true if the capital matched the search text.
+	 */
+	bool CountryListIndex::isCapitalMatch(const int row) const
+	{
+		return mCapitalMatches[row];
+	}
+
+	/**
+	 * Get the number of sections.
+	 * @return Number of sections.
+	 */
+	int CountryListIndex::countSections() const
+	{
+		return mSectionStarts.size();
+	}
+
+	/**
+	 * Find the section that contains a row.
+	 * @param row Row index. Must be >=0 and < countRows().
+	 * @return Section index.
+	 */
+	int CountryListIndex::findSection(const int row) const
+	{
+		// Find the last section that starts at or before the row.
+		int low = 0;
+		int high = mSectionStarts.size() - 1;
+		while (low < high)
+		{
+			int middle = (low + high + 1) / 2;
+			if (mSectionStarts[middle] <= row)
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle - 1;
+			}
+		}
+		return low;
+	}
+
+	/**
+	 * Get the letter of a section.
+	 * @param section Section index. Must be >=0 and < countSections().
+	 * @return Section letter.
+	 */
+	char CountryListIndex::getSectionLetter(const int section) const
+	{
+		return mSectionLetters[section];
+	}
+
+	/**
+	 * Get the first row of a section.
+	 * @param section Section index. Must be >=0 and < countSections().
+	 * @return Row index.
+	 */
+	int CountryListIndex::getSectionStart(const int section) const
+	{
+		return mSectionStarts[section];
+	}
+
+	/**
+	 * Get the row after the last row of a section.
+	 * @param section Section index. Must be >=0 and < countSections().
+	 * @return Row index.
+	 */
+	int CountryListIndex::getSectionEnd(const int section) const
+	{
+		if (section + 1 < mSectionStarts.size())
+		{
+			return mSectionStarts[section + 1];
+		}
+		return mCountryIDs.size();
+	}
+
+} // end of EuropeanCountries
@@ -0,0 +1,148 @@
+/*
+ Copyright (C) 2012 MoSync AB
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License,
+ version 2, as published by the Free Software Foundation.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program; if not, write to the Free Software
+ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ MA 02110-1301, USA.
+ */
+
+/**
+ * @file CountryListIndex.h
+ * @author Bogdan Iusco
+ *
+ * @brief Rows and sections of the countries list.
+ */
+
+#ifndef EC_COUNTRY_LIST_INDEX_H_
+#define EC_COUNTRY_LIST_INDEX_H_
+
+#include <MAUtil/Vector.h>
+
+namespace EuropeanCountries
+{
+
+	/**
+	 * @brief Rows and sections of the countries list.
+	 * Holds all rows of the list, while only some of them are shown by
+	 * widgets. A section is a range of consecutive rows with the same
+	 * letter, so its header can be found for any row without creating
+	 * the widgets of the other sections.
+	 */
+	class CountryListIndex
+	{
+	public:
+		/**
+		 * Constructor.
+		 */
+		CountryListIndex();
+
+		/**
+		 * Remove all rows and sections.
+		 */
+		void clear();
+
+		/**
+		 * Add a row at the end of the list.
+		 * A new section is started if its letter differs from the letter
+		 * of the previous row.
+		 * @param countryID Id of the country shown by the row.
+		 * @param sectionLetter Letter of the row's section.
+		 * @param matchedCapital True if the country was found by its
+		 * capital.
+		 */
+		void addRow(
+			const int countryID,
+			const char sectionLetter,
+			const bool matchedCapital);
+
+		/**
+		 * Get the number of rows.
+		 * @return Number of rows.
+		 */
+		int countRows() const;
+
+		/**
+		 * Get the country shown by a row.
+		 * @param row Row index. Must be >=0 and < countRows().
+		 * @return Country's id.
+		 */
+		int getCountryID(const int row) const;
+
+		/**
+		 * Check if the country of a row was found by its capital.
+		 * @param row Row index. Must be >=0 and < countRows().
+		 * @return true if the capital matched the search text.
+		 */
+		bool isCapitalMatch(const int row) const;
+
+		/**
+		 * Get the number of sections.
+		 * @return Number of sections.
+		 */
+		int countSections() const;
+
+		/**
+		 * Find the section that contains a row.
+		 * @param row Row index. Must be >=0 and < countRows().
+		 * @return Section index.
+		 */
+		int findSection(const int row) const;
+
+		/**
+		 * Get the letter of a section.
+		 * @param section Section index. Must be >=0 and < countSections().
+		 * @return Section letter.
+		 */
+		char getSectionLetter(const int section) const;
+
+		/**
+		 * Get the first row of a section.
+		 * @param section Section index. Must be >=0 and < countSections().
+		 * @return Row index.
+		 */
+		int getSectionStart(const int section) const;
+
+		/**
+		 * Get the row after the last row of a section.
+		 * @param section Section index. Must be >=0 and < countSections().
+		 * @return Row index.
+		 */
+		int getSectionEnd(const int section) const;
+
+	private:
+		/**
+		 * Country id of each row.
+		 */
+		MAUtil::Vector<int> mCountryIDs;
+
+		/**
+		 * Element i is true if the country of row i was found by its
+		 * capital.
+		 */
+		MAUtil::Vector<bool> mCapitalMatches;
+
+		/**
+		 * Letter of each section.
+		 */
+		MAUtil::Vector<char> mSectionLetters;
+
+		/**
+		 * First row of each section, ascending.
+		 */
+		MAUtil::Vector<int> mSectionStarts;
+
+	}; // end of CountryListIndex
+
+} // end of EuropeanCountries
+
+#endif /* EC_COUNTRY_LIST_INDEX_H_ */
@@ -20,16 +20,20 @@
  * @file LoadingScreen.cpp
  * @author Bogdan Iusco
  *
- * @brief NativeUI Screen used to show an ActivityIndicatior.
+ * @brief NativeUI Screen used to show an ActivityIndicatior and the
+ * loading progress.
  * It does not interact with the user, used only when the application
  * is reading data from files.
  */
 
 #define LOADING_LABEL_TEXT "Loading..."
+#define LOADING_LABEL_BUF_SIZE 32
 
 #include <NativeUI/ActivityIndicator.h>
 #include <NativeUI/Label.h>
+#include <NativeUI/ProgressBar.h>
 #include <NativeUI/VerticalLayout.h>
+#include <mastdlib.h>
 
 #include "LoadingScreen.h"
 #include "ViewUtils.h"
@@ -41,11 +45,41 @@ namespace EuropeanCountries
 	 * Constructor.
 	 */
 	LoadingScreen::LoadingScreen():
-		mMainLayout(NULL)
+		mMainLayout(NULL),
+		mLoadingLabel(NULL),
+		mProgressBar(NULL),
+		mPercent(-1)
 	{
 		this->createUI();
 	}
 
+	/**
+	 * Show the loading progress.
+	 * @param countLoaded Number of files already read.
+	 * @param countTotal Number of files to read. If zero the progress
+	 * is not known and nothing is shown.
+	 */
+	void LoadingScreen::setProgress(const int countLoaded, const int countTotal)
+	{
+		if (countTotal <= 0)
+		{
+			return;
+		}
+
+		// Widgets are updated only when the shown value changes.
+		int percent = (int) (countLoaded * 100.0 / countTotal);
+		if (percent == mPercent)
+		{
+			return;
+		}
+		mPercent = percent;
+
+		char text[LOADING_LABEL_BUF_SIZE];
+		sprintf(text, "%s %d%%", LOADING_LABEL_TEXT, percent);
+		mLoadingLabel->setText(text);
+		mProgressBar->setProgress(percent);
+	}
+
 	/**
 	 * Create screen's UI.
 	 */
@@ -63,14 +97,20 @@ namespace EuropeanCountries
 			new NativeUI::ActivityIndicator();
 		mMainLayout->addChild(activityIndicator);
 
+		// Add the progress widgets.
+		mLoadingLabel = new NativeUI::Label(LOADING_LABEL_TEXT);
+		mLoadingLabel->setTextHorizontalAlignment(MAW_ALIGNMENT_CENTER);
+		mLoadingLabel->fillSpaceHorizontally();
+		mMainLayout->addChild(mLoadingLabel);
+
+		mMainLayout->addChild(createSpacer(SPACER_HEIGHT));
+		mProgressBar = new NativeUI::ProgressBar();
+		mProgressBar->setMaximumValue(100);
+		mProgressBar->fillSpaceHorizontally();
+		mMainLayout->addChild(mProgressBar);
+
 		if (isWindowsPhone())
 		{
-			// For WP7 platform add an Label widget.
-			NativeUI::Label* loading = new NativeUI::Label(LOADING_LABEL_TEXT);
-			loading->setTextHorizontalAlignment(MAW_ALIGNMENT_CENTER);
-			loading->fillSpaceHorizontally();
-			mMainLayout->addChild(loading);
-
 			mMainLayout->addChild(createSpacer(SPACER_HEIGHT));
 			activityIndicator->fillSpaceHorizontally();
 		}
@@ -20,7 +20,8 @@
  * @file LoadingScreen.h
  * @author Bogdan Iusco
  *
- * @brief NativeUI Screen used to show an ActivityIndicatior.
+ * @brief NativeUI Screen used to show an ActivityIndicatior and the
+ * loading progress.
  * It does not interact with the user, used only when the application
  * is reading data from files.
  */
@@ -32,6 +33,8 @@
 
 namespace NativeUI
 {
+	class Label;
+	class ProgressBar;
 	class VerticalLayout;
 }
 
@@ -39,7 +42,7 @@ namespace EuropeanCountries
 {
 
 	/**
-	 * @brief Show an ActivityIndicator to the user.
+	 * @brief Show an ActivityIndicator and the loading progress to the user.
 	 */
 	class LoadingScreen:
 		public NativeUI::Screen
@@ -50,6 +53,14 @@ namespace EuropeanCountries
 		 */
 		LoadingScreen();
 
+		/**
+		 * Show the loading progress.
+		 * @param countLoaded Number of files already read.
+		 * @param countTotal Number of files to read. If zero the progress
+		 * is not known and nothing is shown.
+		 */
+		void setProgress(const int countLoaded, const int countTotal);
+
 	private:
 		/**
 		 * Create screen's UI.
@@ -61,6 +72,21 @@ namespace EuropeanCountries
 		 * Screen's main layout.
 		 */
 		NativeUI::VerticalLayout* mMainLayout;
+
+		/**
+		 * Shows the loading text and the percent of files read.
+		 */
+		NativeUI::Label* mLoadingLabel;
+
+		/**
+		 * Shows the percent of files read.
+		 */
+		NativeUI::ProgressBar* mProgressBar;
+
+		/**
+		 * Last percent shown, or -1 if none was shown.
+		 */
+		int mPercent;
 	}; // end of LoadingScreen
 
 } // end of EuropeanCountries
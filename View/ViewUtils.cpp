@@ -156,6 +156,21 @@ namespace EuropeanCountries
 		return layout;
 	}
 
+	/**
+	 * Set a text property of a widget.
+	 * The text is passed directly to the widget, no MAUtil::String is created.
+	 * @param widget Widget to change.
+	 * @param property Property name(e.g. MAW_LABEL_TEXT).
+	 * @param text Null terminated text to set.
+	 */
+	void setWidgetText(
+		NativeUI::Widget* widget,
+		const char* property,
+		const char* text)
+	{
+		maWidgetSetProperty(widget->getWidgetHandle(), property, text);
+	}
+
 	/**
 	 * Detects if the current platform is Android.
 	 * @return true if the platform is Android, false otherwise.
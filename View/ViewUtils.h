@@ -40,6 +40,7 @@ namespace NativeUI
 {
 	class Label;
 	class VerticalLayout;
+	class Widget;
 }
 
 namespace EuropeanCountries
@@ -115,6 +116,18 @@ namespace EuropeanCountries
 		const int height = SPACER_HEIGHT,
 		const int width = MAW_CONSTANT_FILL_AVAILABLE_SPACE);
 
+	/**
+	 * Set a text property of a widget.
+	 * The text is passed directly to the widget, no MAUtil::String is created.
+	 * @param widget Widget to change.
+	 * @param property Property name(e.g. MAW_LABEL_TEXT).
+	 * @param text Null terminated text to set.
+	 */
+	void setWidgetText(
+		NativeUI::Widget* widget,
+		const char* property,
+		const char* text);
+
 	/**
 	 * Detects if the current platform is Android.
 	 * @return true if the platform is Android, false otherwise.
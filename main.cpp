@@ -64,6 +64,9 @@ namespace EuropeanCountries
 
 } // end of EuropeanCountries
 
+// When EC_BENCHMARK is defined Benchmark/BenchmarkMain.cpp provides MAMain.
+#ifndef EC_BENCHMARK
+
 /**
  * Main function that is called when the program starts.
  */
@@ -72,3 +75,5 @@ extern "C" int MAMain()
 	MAUtil::Moblet::run(new EuropeanCountries::NativeUIMoblet());
 	return 0;
 }
+
+#endif /* EC_BENCHMARK */